@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/BinaryLog.h>
+#include <commons/log/Log.h>
+#include <commons/log/impl/FileLogger.h>
+#include <commons/log/impl/FlightRecorderLogger.h>
+#include <commons/log/impl/RotatingFileLogger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Usage: commons_bench [<records per thread>] [<max threads>]
+ *
+ * Measures the cost of log statements for the calling thread in several logger setups, with 1 to max threads logging
+ * concurrently (doubling each step). Reports throughput as nanoseconds per record over all threads and the latency
+ * distribution of single statements, and the heap allocations per record made by the logging threads. A record path
+ * that is allocation-free after warm-up reports 0.00. Results are written to stderr, run with stdout redirected to /dev/null to keep
+ * the stdout setup from flooding the terminal.
+ */
+
+// counts allocations of threads that enabled counting
+static thread_local bool gCountAllocations = false;
+static std::atomic<uint64_t> gAllocations = ATOMIC_VAR_INIT(0);
+
+void *operator new(size_t size) {
+    if (gCountAllocations)
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+// not inlined, so that the compiler does not pair the free with new expressions
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+    std::free(p);
+}
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        double nanosPerRecord;
+        double allocationsPerRecord;
+        std::vector<int64_t> latencies;
+    };
+
+    int64_t percentile(const std::vector<int64_t> &sorted, double p) {
+        if (sorted.empty())
+            return 0;
+        return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+    }
+
+    /**
+     * Runs statement records times on each of threads threads, all starting at once
+     */
+    Result run(size_t threads, size_t records, const std::function<void(size_t)> &statement) {
+        std::vector<std::vector<int64_t>> latencies(threads, std::vector<int64_t>(records));
+        std::vector<std::thread> workers;
+        std::atomic<size_t> ready = ATOMIC_VAR_INIT(0);
+        std::atomic_bool go = ATOMIC_VAR_INIT(false);
+
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] () {
+                auto &own = latencies[t];
+                ready.fetch_add(1);
+                while (!go.load())
+                    std::this_thread::yield();
+
+                gCountAllocations = true;
+                for (size_t i = 0; i < records; i++) {
+                    auto begin = Clock::now();
+                    statement(i);
+                    own[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+                }
+                gCountAllocations = false;
+            });
+        }
+
+        while (ready.load() < threads)
+            std::this_thread::yield();
+        uint64_t allocations = gAllocations.load();
+        auto begin = Clock::now();
+        go.store(true);
+        for (auto &worker : workers)
+            worker.join();
+        // async records are only complete once written
+        Log::get().flush();
+        auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+
+        auto total = static_cast<double>(threads * records);
+        Result result {static_cast<double>(wall) / total, static_cast<double>(gAllocations.load() - allocations) / total,
+                       {}};
+        for (auto &own : latencies)
+            result.latencies.insert(result.latencies.end(), own.begin(), own.end());
+        std::sort(result.latencies.begin(), result.latencies.end());
+        return result;
+    }
+
+    void report(const std::string &setup, size_t threads, const Result &result) {
+        const auto &sorted = result.latencies;
+        std::cerr << std::left << std::setw(16) << setup << std::right << std::setw(8) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(1) << result.nanosPerRecord
+                  << std::setw(10) << percentile(sorted, 0.5) << std::setw(10) << percentile(sorted, 0.99)
+                  << std::setw(10) << percentile(sorted, 0.999) << std::setw(12) << sorted.back()
+                  << std::setw(12) << std::setprecision(2) << result.allocationsPerRecord << std::endl;
+    }
+
+    void logStatement(size_t i) {
+        L_info << "Benchmark record " << i << " with some payload " << 3.14159 << ' ' << "text";
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t records = argc > 1 ? std::stoul(argv[1]) : 100000;
+    size_t maxThreads = std::max<size_t>(1, argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency());
+
+    const char *logFile = "commons_bench.log";
+    const char *rotatingFile = "commons_bench_rotating.log";
+    const char *flightFile = "commons_bench.rec";
+    const char *binaryFile = "commons_bench.blog";
+
+    std::unique_ptr<FileLogger> file;
+    std::unique_ptr<RotatingFileLogger> rotating;
+    std::unique_ptr<FlightRecorderLogger> flight;
+    std::unique_ptr<BinaryLogger> binary;
+    std::vector<ILogger *> registered;
+
+    auto useLoggers = [&] (std::vector<ILogger *> loggers) {
+        for (ILogger *logger : registered)
+            Log::get().unregisterLogger(logger);
+        registered = std::move(loggers);
+        for (ILogger *logger : registered)
+            Log::get().registerLogger(logger);
+    };
+
+    // each setup prepares the Log, statement defaults to logStatement
+    struct Setup {
+        std::string name;
+        std::function<void()> prepare;
+        std::function<void(size_t)> statement = logStatement;
+    };
+    std::vector<Setup> setups = {
+        {"disabled", [&] () {
+            useLoggers({});
+            Log::get().setLogLevel(LogLevel::LEVEL_WARNING);
+        }},
+        {"stdout", [&] () {
+            useLoggers({});
+            Log::get().setLogLevel(LogLevel::LEVEL_TRACE);
+        }},
+        {"file", [&] () {
+            file = std::make_unique<FileLogger>(logFile);
+            useLoggers({file.get()});
+        }},
+        {"multi", [&] () {
+            RotatingFileLogger::Config config;
+            config.flushIntervalMillis = 100;
+            rotating = std::make_unique<RotatingFileLogger>(rotatingFile, config);
+            flight = std::make_unique<FlightRecorderLogger>(flightFile);
+            useLoggers({file.get(), rotating.get(), flight.get()});
+        }},
+        {"async-file", [&] () {
+            useLoggers({file.get()});
+            Log::get().enableAsync();
+        }},
+        {"async-multi", [&] () {
+            useLoggers({file.get(), rotating.get(), flight.get()});
+        }},
+        {"binary", [&] () {
+            Log::get().disableAsync();
+            useLoggers({});
+            binary = std::make_unique<BinaryLogger>(binaryFile);
+        }, [&binary] (size_t i) {
+            L_bin(*binary, LEVEL_INFO, "Benchmark record {} with some payload {} {}", i, 3.14159, "text");
+        }},
+    };
+
+    std::cerr << std::left << std::setw(16) << "setup" << std::right << std::setw(8) << "threads"
+              << std::setw(12) << "ns/record" << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns"
+              << std::setw(10) << "p99.9 ns" << std::setw(12) << "max ns" << std::setw(12) << "allocs/rec" << std::endl;
+
+    // powers of two below maxThreads, then maxThreads
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    for (auto &setup : setups) {
+        setup.prepare();
+        for (size_t threads : threadCounts)
+            report(setup.name, threads, run(threads, records, setup.statement));
+    }
+
+    useLoggers({});
+    binary.reset();
+    flight.reset();
+    rotating.reset();
+    file.reset();
+    for (const char *name : {logFile, rotatingFile, flightFile, binaryFile})
+        std::remove(name);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_ASYNCLOGWORKER_H
+#define COMMONS_ASYNCLOGWORKER_H
+
+#include <commons/log/Log.h>
+#include <commons/thread/IQueueWorker.h>
+#include <commons/thread/impl/LockFreeQueue.h>
+
+#include <string>
+
+/**
+ * A formatted log record on its way to the loggers
+ */
+struct AsyncLogRecord {
+    LogLevel level = LogLevel::VALUE_INVALID;
+    std::string text;
+    // logging context, see LogRecordContext
+    size_t prefixSize = 0;
+    std::string fields;
+};
+
+/**
+ * Background worker of asynchronous logging. Writes records to the loggers of Log in the order they were queued.
+ * Always uses the lock-free queue, so logging threads never contend on a lock.
+ */
+class AsyncLogWorker : public IQueueWorker<AsyncLogRecord> {
+public:
+    explicit AsyncLogWorker(Log &log) : IQueueWorker(new LockFreeQueue<AsyncLogRecord>(), "log"), mLog(log) { }
+    ~AsyncLogWorker() override {
+        // stop before vtable of this class is gone
+        stopThread();
+    }
+
+    /**
+     * Writes records left in the queue on the calling thread. Only valid after the thread has been stopped.
+     */
+    void drain() {
+        AsyncLogRecord record;
+        while (mQueue->pop(record)) {
+            // empty control message of abort
+            if (record.level != LogLevel::VALUE_INVALID)
+                doWork(record);
+        }
+    }
+
+protected:
+    void doWork(const AsyncLogRecord &record) override {
+        mLog.writeRecord(record.level, record.text, {record.prefixSize, record.fields});
+        mLog.mAsyncPending.fetch_sub(1);
+    }
+
+    Log &mLog;
+};
+
+#endif //COMMONS_ASYNCLOGWORKER_H
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_BINARYLOG_H
+#define COMMONS_BINARYLOG_H
+
+#include <commons/log/Log.h>
+#include <commons/util/Time.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Static description of a binary log call site. Created once per call site by L_bin.
+ */
+class BinaryLogSite {
+public:
+    /**
+     * @param level LogLevel of all records of this site
+     * @param format Format string, each "{}" is replaced by the next argument on decoding
+     * @param file Source file
+     * @param line Source line
+     */
+    BinaryLogSite(LogLevel level, const char *format, const char *file, uint32_t line)
+            : mId(mNextId.fetch_add(1, std::memory_order_relaxed)), mLevel(level), mFormat(format), mFile(file),
+              mLine(line) { }
+
+    uint32_t id() const {
+        return mId;
+    }
+    LogLevel level() const {
+        return mLevel;
+    }
+    const char *format() const {
+        return mFormat;
+    }
+    const char *file() const {
+        return mFile;
+    }
+    uint32_t line() const {
+        return mLine;
+    }
+
+protected:
+    uint32_t mId;
+    LogLevel mLevel;
+    const char *mFormat;
+    const char *mFile;
+    uint32_t mLine;
+
+    static inline std::atomic<uint32_t> mNextId = ATOMIC_VAR_INIT(0);
+};
+
+/**
+ * Binary log format, all values in native byte order.
+ *
+ * A file is a sequence of sessions. Each session starts with the 8 byte MAGIC, followed by entries that start with
+ * their EntryType. Call sites are described once per session before their first record, records only contain the
+ * site id, a timestamp and the raw argument values.
+ */
+namespace BinaryLogFormat {
+    constexpr char MAGIC[8] = {'V', 'D', 'B', 'L', 'O', 'G', '1', '\0'};
+
+    enum EntryType : uint8_t {
+        // u32 id, u8 level, u32 line, u32 file size, file, u32 format size, format
+        ENTRY_SITE = 1,
+        // u32 id, i64 timestamp in milliseconds, u8 argument count, tagged arguments
+        ENTRY_RECORD = 2,
+    };
+
+    enum ArgTag : uint8_t {
+        ARG_INT = 1,        // i64
+        ARG_UINT = 2,       // u64
+        ARG_DOUBLE = 3,     // f64
+        ARG_BOOL = 4,       // u8
+        ARG_CHAR = 5,       // u8
+        ARG_STRING = 6,     // u32 size, bytes
+        ARG_POINTER = 7,    // u64
+    };
+}
+
+/**
+ * Writes binary log records with deferred formatting to a file. Use BinaryLogDecoder to turn the file into text.
+ *
+ * Each thread appends its records to its own buffer, so a record costs a few memcpys and no locks. Full buffers are
+ * handed to a background thread that writes them to the file. Records of one thread stay in order, records of
+ * different threads are grouped by buffer. Logging only blocks if the file falls behind by several buffers.
+ *
+ * Supported argument types are integers, floating point numbers, bool, characters, strings and pointers.
+ */
+class BinaryLogger {
+public:
+    /**
+     * Opens the file for appending and starts a new session
+     *
+     * @param filename File to write
+     * @param bufferSize Bytes buffered per thread before handing them to the background thread
+     */
+    explicit BinaryLogger(const std::string &filename, size_t bufferSize = 64 * 1024);
+    ~BinaryLogger();
+
+    /**
+     * @return Whether the file is open
+     */
+    bool isOpen() const {
+        return mFile.is_open();
+    }
+
+    /**
+     * Writes a record. Thread-safe.
+     *
+     * @param site Call site of the record
+     * @param args Values to be formatted into the site's format on decoding
+     */
+    template<typename... Args>
+    void log(const BinaryLogSite &site, const Args &...args) {
+        static_assert(sizeof...(Args) <= UINT8_MAX, "Too many arguments");
+        ThreadBuffer &buffer = threadBuffer();
+
+        size_t recordSize = 1 + sizeof(uint32_t) + sizeof(int64_t) + 1 + (argSize(args) + ... + 0);
+        bool describe = !buffer.described(site.id());
+        size_t size = recordSize + (describe ? siteSize(site) : 0);
+
+        // sites are described once per chunk, so every chunk decodes on its own
+        Chunk *chunk = buffer.active.load(std::memory_order_relaxed);
+        size_t offset = chunk->committed.load(std::memory_order_relaxed);
+        if (offset + size > chunk->capacity) {
+            chunk = nextChunk(buffer, recordSize + siteSize(site));
+            describe = true;
+            offset = 0;
+        }
+
+        char *out = chunk->data.get() + offset;
+        if (describe) {
+            out = putSite(out, site);
+            buffer.setDescribed(site.id());
+        }
+        out = put<uint8_t>(out, BinaryLogFormat::ENTRY_RECORD);
+        out = put<uint32_t>(out, site.id());
+        out = put<int64_t>(out, CoarseClock::logNow());
+        out = put<uint8_t>(out, sizeof...(Args));
+        ((out = putArg(out, args)), ...);
+
+        // publishes the record to flush()
+        chunk->committed.store(static_cast<size_t>(out - chunk->data.get()), std::memory_order_release);
+    }
+
+    /**
+     * Writes all records logged so far to the file
+     */
+    void flush();
+
+protected:
+    struct Chunk {
+        explicit Chunk(size_t size) : data(new char[size]), capacity(size) { }
+
+        std::unique_ptr<char[]> data;
+        size_t capacity;
+        // bytes of complete records, only advanced by the owning thread
+        std::atomic<size_t> committed = ATOMIC_VAR_INIT(0);
+        // bytes written to the file, requires mFileMutex
+        size_t written = 0;
+    };
+
+    struct ThreadBuffer {
+        bool described(uint32_t id) const {
+            return id < sitesDescribed.size() && sitesDescribed[id];
+        }
+        void setDescribed(uint32_t id) {
+            if (id >= sitesDescribed.size())
+                sitesDescribed.resize(id + 1);
+            sitesDescribed[id] = true;
+        }
+
+        // chunk the owning thread appends to, read by flush()
+        std::atomic<Chunk *> active = ATOMIC_VAR_INIT(nullptr);
+        // set once the owning thread exited
+        std::atomic_bool abandoned = ATOMIC_VAR_INIT(false);
+        // per site id, whether it has been described in the active chunk, owning thread only
+        std::vector<bool> sitesDescribed;
+    };
+
+    // buffers of the current thread, per logger
+    struct LocalBuffers {
+        ~LocalBuffers() {
+            for (auto &entry : entries)
+                entry.second->abandoned.store(true, std::memory_order_release);
+        }
+
+        std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> entries;
+    };
+
+    ThreadBuffer &threadBuffer() {
+        for (auto &entry : mLocalBuffers.entries)
+            if (entry.first == mId)
+                return *entry.second;
+        return registerThread();
+    }
+
+    template<typename T>
+    static char *put(char *out, T value) {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    static char *putBytes(char *out, std::string_view bytes) {
+        out = put<uint32_t>(out, static_cast<uint32_t>(bytes.size()));
+        std::memcpy(out, bytes.data(), bytes.size());
+        return out + bytes.size();
+    }
+
+    // checked in the order std::ostream would choose its overload
+    template<typename T>
+    static constexpr BinaryLogFormat::ArgTag argTag() {
+        using namespace BinaryLogFormat;
+        using V = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<V, bool>)
+            return ARG_BOOL;
+        else if constexpr (std::is_same_v<V, char> || std::is_same_v<V, signed char>
+                || std::is_same_v<V, unsigned char>)
+            return ARG_CHAR;
+        else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+            return ARG_INT;
+        else if constexpr (std::is_integral_v<V>)
+            return ARG_UINT;
+        else if constexpr (std::is_floating_point_v<V>)
+            return ARG_DOUBLE;
+        else if constexpr (std::is_convertible_v<const T &, std::string_view>)
+            return ARG_STRING;
+        else if constexpr (std::is_pointer_v<V>)
+            return ARG_POINTER;
+        else
+            static_assert(sizeof(V) == 0, "Unsupported binary log argument type");
+    }
+
+    template<typename T>
+    static size_t argSize(const T &value) {
+        constexpr BinaryLogFormat::ArgTag tag = argTag<T>();
+
+        if constexpr (tag == BinaryLogFormat::ARG_STRING)
+            return 1 + sizeof(uint32_t) + std::string_view(value).size();
+        else if constexpr (tag == BinaryLogFormat::ARG_BOOL || tag == BinaryLogFormat::ARG_CHAR)
+            return 1 + sizeof(uint8_t);
+        else
+            return 1 + sizeof(uint64_t);
+    }
+
+    template<typename T>
+    static char *putArg(char *out, const T &value) {
+        using namespace BinaryLogFormat;
+        constexpr ArgTag tag = argTag<T>();
+
+        out = put<uint8_t>(out, tag);
+        if constexpr (tag == ARG_BOOL || tag == ARG_CHAR)
+            return put<uint8_t>(out, static_cast<uint8_t>(value));
+        else if constexpr (tag == ARG_INT)
+            return put<int64_t>(out, value);
+        else if constexpr (tag == ARG_UINT)
+            return put<uint64_t>(out, value);
+        else if constexpr (tag == ARG_DOUBLE)
+            return put<double>(out, static_cast<double>(value));
+        else if constexpr (tag == ARG_STRING)
+            return putBytes(out, std::string_view(value));
+        else
+            return put<uint64_t>(out, reinterpret_cast<uintptr_t>(value));
+    }
+
+    static size_t siteSize(const BinaryLogSite &site);
+    static char *putSite(char *out, const BinaryLogSite &site);
+
+    // slow paths, called without any lock held
+    ThreadBuffer &registerThread();
+    // hands the active chunk of buffer to the background thread and replaces it by one of at least minSize bytes
+    Chunk *nextChunk(ThreadBuffer &buffer, size_t minSize);
+
+    // requires mMutex
+    Chunk *takeChunk(size_t minSize);
+    void recycleChunk(Chunk *chunk);
+    // requires mFileMutex
+    void writeChunk(Chunk *chunk);
+
+    void writeEntry();
+
+    uint64_t mId;
+    size_t mBufferSize;
+
+    // file and bytes written to it, locked only by flush() and the background thread
+    std::mutex mFileMutex;
+    std::ofstream mFile;
+
+    // chunks and registered threads
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::vector<std::unique_ptr<Chunk>> mChunks;
+    std::vector<Chunk *> mFree;
+    std::vector<Chunk *> mPending;
+    std::vector<std::shared_ptr<ThreadBuffer>> mThreadBuffers;
+
+    std::thread mThread;
+    bool mStopped = false;
+
+    static inline std::atomic<uint64_t> mNextId = ATOMIC_VAR_INIT(0);
+    static inline thread_local LocalBuffers mLocalBuffers;
+};
+
+/**
+ * Turns binary logs back into text
+ */
+class BinaryLogDecoder {
+public:
+    /**
+     * Decodes a binary log into the lines FileLogger would have written for the same records
+     *
+     * @param in Binary log
+     * @param out Text output
+     * @return False if the input is corrupt or ends within an entry, all complete records before are decoded
+     */
+    static bool decode(std::istream &in, std::ostream &out);
+};
+
+/**
+ * Writes a binary log record to a BinaryLogger, if the level is compiled in and enabled in Log.
+ * The format string is stored once, arguments are formatted only on decoding.
+ *
+ * Usage: L_bin(logger, LEVEL_INFO, "Connected to {} in {}ms", host, millis);
+ */
+#define L_bin(logger, level, format, ...)                                                       \
+    do {                                                                                        \
+        if constexpr (Log::isCompiled(LogLevel::level)) {                                       \
+            static const BinaryLogSite _site(LogLevel::level, format, __FILE__, __LINE__);      \
+            if (Log::get().isLevelEnabled(LogLevel::level))                                     \
+                (logger).log(_site, ##__VA_ARGS__);                                             \
+        }                                                                                       \
+    } while (false)
+
+#endif //COMMONS_BINARYLOG_H
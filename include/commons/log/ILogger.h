@@ -22,10 +22,23 @@
 
 #include <enum/logger/LogLevel.h>
 
+#include <ostream>
+#include <string_view>
+
+/**
+ * Logging context of a record, see LogContext
+ */
+struct LogRecordContext {
+    // size of the rendered context prefix at the start of the record
+    size_t prefixSize = 0;
+    // context entries, encoded as in LogContext::fields()
+    std::string_view fields;
+};
+
 /**
  * Interface a Logger has to implement.
- * For every log stream (a chain of << calls) wantsLog(LogLevel) is called. If it returns true, logged values will be
- * passed to ILogger implementation.
+ * Every log stream (a chain of << calls) is formatted once and passed as a finished record to write(). The default
+ * implementation calls wantsLog(LogLevel) and, if it returns true, writes the record to stream() and flushes.
  */
 class ILogger {
 public:
@@ -66,6 +79,33 @@ public:
      */
     virtual std::ostream &stream() = 0;
 
+    /**
+     * Writes a finished record. Called with the log lock held, so implementations need no locking of their own.
+     *
+     * @param record Formatted record without line terminator, only valid during the call
+     * @param level LogLevel of the record
+     */
+    virtual void write(std::string_view record, LogLevel level) {
+        if (wantsLog(level) && isOpen()) {
+            stream().write(record.data(), static_cast<std::streamsize>(record.size()));
+            flush();
+        }
+    }
+
+    /**
+     * Writes a finished record together with the logging context of the thread it was logged on. The record starts
+     * with the rendered context prefix. Loggers supporting structured fields can override this to write the context
+     * as fields and the record without prefix. The default implementation calls write(record, level).
+     *
+     * @param record Formatted record including the context prefix, only valid during the call
+     * @param level LogLevel of the record
+     * @param context Context of the record, only valid during the call
+     */
+    virtual void writeWithContext(std::string_view record, LogLevel level, const LogRecordContext &context) {
+        (void) context;
+        write(record, level);
+    }
+
     /**
      * @param level LogLevel
      * @return Whether ILogger implementation wants to log stream started by this log level.
@@ -21,16 +21,39 @@
 #define COMMONS_LOG_H
 
 #include <commons/log/ILogger.h>
+#include <commons/log/LogContext.h>
+#include <commons/log/LogRecordStream.h>
 #include <commons/log/impl/StdoutLogger.h>
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <ostream>
 #include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// lowest LogLevel compiled into L_* log statements, set by CMake option COMMONS_LOG_MIN_LEVEL
+#ifndef COMMONS_LOG_MIN_LEVEL
+    #define COMMONS_LOG_MIN_LEVEL 0
+#endif
+
+class AsyncLogWorker;
 
 /**
  * General purpose logging class. ILoggers can be registered to direct different log levels to different outputs.
  */
 class Log {
+    /**
+     * Handling of a single log record
+     */
+    enum class RecordMode {
+        Skip,   /**< Record is discarded **/
+        Sync,   /**< Record is written to loggers on the calling thread **/
+        Async,  /**< Record is formatted on the calling thread and written by the async worker **/
+    };
+
     /**
      * Provides a wrapper for std::ostream that streams all logged values to Log's registered loggers.
      * @tparam Level Assigned LogLevel
@@ -38,30 +61,34 @@ class Log {
     template <LogLevel Level>
     class LogStream {
         /**
-         * Chained stream operator calls will use the following class, that logs only if a ILogger declared it wants to log
-         * the current stream.
+         * Chained stream operator calls will use the following class, that formats all values of a log record into the
+         * record buffer of the calling thread. The finished record is passed to the loggers on destruction.
          */
         class LogStreamValue {
         public:
             /**
-             * Constructor that accepts the parent LogStream and a vector of enabled ILoggers for this log stream.
+             * Constructor that accepts the parent LogStream and how the record is handled.
              * @param parent
-             * @param enabledLoggers
+             * @param mode How the values of this log stream are handled
+             * @param prefixSize Size of the logging context prefix at the start of the record
              */
-            LogStreamValue(LogStream &parent, std::vector<ILogger*> enabledLoggers) : mParent(parent),
-                                                                                      mEnabledLoggers(std::move(enabledLoggers)) { }
+            LogStreamValue(LogStream &parent, RecordMode mode, size_t prefixSize = 0)
+                    : mParent(parent), mMode(mode), mPrefixSize(prefixSize) { }
             /**
-             * Appends a std::endl to the log entry on destruction.
+             * Passes the finished record to the loggers on destruction.
              */
             ~LogStreamValue() {
-                if (mParent.mLog.isEnabled() && mParent.isEnabled()) {
-                    for (ILogger *logger: mEnabledLoggers) {
-                        if (logger->isOpen())
-                            logger->flush();
-                    }
-
-                    mParent.mLog.mLogLock.unlock();
-                }
+                if (mMode == RecordMode::Skip)
+                    return;
+
+                LogRecordContext context;
+                if (mPrefixSize > 0)
+                    context = {mPrefixSize, LogContext::current().fields()};
+
+                if (mMode == RecordMode::Async)
+                    mParent.mLog.submitAsync(Level, Log::recordBuffer().view(), context);
+                else
+                    mParent.mLog.writeRecord(Level, Log::recordBuffer().view(), context);
             }
 
             /**
@@ -73,23 +100,20 @@ class Log {
              */
             template<typename T>
             LogStreamValue &operator<<(const T &t) {
-                if (mParent.mLog.isEnabled() && mParent.isEnabled()) {
-                    for (ILogger *logger: mEnabledLoggers) {
-                        if (logger->isOpen())
-                            logger->stream() << t;
-                    }
-                }
+                if (mMode != RecordMode::Skip)
+                    Log::recordBuffer() << t;
                 return *this;
             }
 
         protected:
             LogStream &mParent;
-            std::vector<ILogger*> mEnabledLoggers;
+            RecordMode mMode;
+            size_t mPrefixSize;
         };
 
     public:
         /**
-         * Stream operator which is used for logging. This redirects all logged values to the registered ILoggers.
+         * Stream operator which is used for logging. This starts a new record, formatted once for all ILoggers.
          * The subsequent values will be logged by returned LogStreamValue.
          * @tparam T Type of value to be logged
          * @param t Value to log
@@ -97,39 +121,46 @@ class Log {
          */
         template<typename T>
         LogStreamValue operator<<(const T &t) {
-            std::vector<ILogger *> enabledLoggers;
-
-            if (mLog.isEnabled() && mEnabled) {
-                mLog.mLogLock.lock();
-
-                enabledLoggers.reserve(mLog.loggers().size());
-                for (ILogger *logger: mLog.loggers()) {
-                    // only log if logger wants this level
-                    if (logger->wantsLog(Level)) {
-                        // add to list of enabled loggers
-                        enabledLoggers.push_back(logger);
-
-                        // log the first value if it's open
-                        if (logger->isOpen())
-                            logger->stream() << t;
-                    }
-                }
+            if constexpr (!Log::isCompiled(Level))
+                return LogStreamValue(*this, RecordMode::Skip);
+
+            if (!isEnabled())
+                return LogStreamValue(*this, RecordMode::Skip);
+
+            RecordMode mode = mLog.beginRecord();
+            size_t prefixSize = 0;
+            if (mode != RecordMode::Skip) {
+                // no lock is held while formatting, loggers are only called with the finished record
+                prefixSize = Log::startRecord();
+                Log::recordBuffer() << t;
             }
-            return LogStreamValue(*this, enabledLoggers);
+            return LogStreamValue(*this, mode, prefixSize);
         }
 
         /**
-         * @return Whether this log level should be enabled. This respects global enable.
+         * Starts a record without checking whether this level is enabled, for callers that did their own check,
+         * e.g. tagged log statements. The values are logged by the returned LogStreamValue.
+         */
+        LogStreamValue unchecked() {
+            RecordMode mode = mLog.beginRecord();
+            size_t prefixSize = 0;
+            if (mode != RecordMode::Skip)
+                prefixSize = Log::startRecord();
+            return LogStreamValue(*this, mode, prefixSize);
+        }
+
+        /**
+         * @return Whether this log level should be enabled. This respects global enable and the compile-time minimum.
          */
         bool isEnabled() const {
-            return mLog.isEnabled() && mEnabled;
+            return Log::isCompiled(Level) && mLog.isLevelEnabled(Level);
         }
         /**
          * Enables or disabled this log level.
          * @param enabled True if log level should be enabled, false if not.
          */
         void setEnabled(bool enabled) {
-            mEnabled = enabled;
+            mLog.setLevelEnabled(Level, enabled);
         }
 
     protected:
@@ -139,12 +170,19 @@ class Log {
         explicit LogStream(Log &log) : mLog(log) { }
 
         Log &mLog;
-        bool mEnabled = true;
 
         friend class Log;
     };
 
 public:
+    /**
+     * Behavior of async logging if the record queue is full
+     */
+    enum class AsyncFullPolicy {
+        Block,  /**< Wait until the worker made room **/
+        Drop,   /**< Discard the record and count it in droppedRecords() **/
+    };
+
     /**
      * Registers an ILogger to the Log. The ILogger will be opened (if it's not already), if this fails, the ILogger
      * won't be added!
@@ -170,7 +208,7 @@ public:
             case LogLevel::LEVEL_INFO: info.setEnabled(false); break;
             case LogLevel::LEVEL_WARNING: warn.setEnabled(false); break;
             case LogLevel::LEVEL_ERROR: err.setEnabled(false); break;
-            case LogLevel::VALUE_INVALID: mEnabled = false; break;
+            case LogLevel::VALUE_INVALID: setEnabled(false); break;
         }
     }
     /**
@@ -185,7 +223,7 @@ public:
             case LogLevel::LEVEL_INFO: info.setEnabled(true); break;
             case LogLevel::LEVEL_WARNING: warn.setEnabled(true); break;
             case LogLevel::LEVEL_ERROR: err.setEnabled(true); break;
-            case LogLevel::VALUE_INVALID: mEnabled = true; break;
+            case LogLevel::VALUE_INVALID: setEnabled(true); break;
         }
     }
     /**
@@ -194,31 +232,64 @@ public:
      *              log levels as well as the global level.
      */
      void setLogLevel(LogLevel level) {
-         bool found;
-         trac.setEnabled(found = (level == LogLevel::LEVEL_TRACE));
-         dbg.setEnabled(found = (found || level == LogLevel::LEVEL_DEBUG));
-         info.setEnabled(found = (found || level == LogLevel::LEVEL_INFO));
-         warn.setEnabled(found = (found || level == LogLevel::LEVEL_WARNING));
-         err.setEnabled(found = (found || level == LogLevel::LEVEL_ERROR));
-         mEnabled = found;
+         uint8_t bits = 0;
+         // this level and all above, plus global enable
+         if (level != LogLevel::VALUE_INVALID)
+             bits = GLOBAL_ENABLED_BIT | levelMask(level);
+         mLevelBits.store(bits, std::memory_order_relaxed);
+         updateTagLevels();
      }
 
     /**
      * @return Global log enabled status, which has priority over individual enabled status of log levels.
      */
     bool isEnabled() const {
-        return mEnabled;
+        return mLevelBits.load(std::memory_order_relaxed) & GLOBAL_ENABLED_BIT;
     }
     void setEnabled(bool value = true) {
-        mEnabled = value;
+        if (value)
+            mLevelBits.fetch_or(GLOBAL_ENABLED_BIT, std::memory_order_relaxed);
+        else
+            mLevelBits.fetch_and(static_cast<uint8_t>(~GLOBAL_ENABLED_BIT), std::memory_order_relaxed);
+        updateTagLevels();
+    }
+
+    /**
+     * Checks a level with a single relaxed load, so that disabled log statements are nearly free.
+     *
+     * @param level LogLevel
+     * @return Whether the level and logging in general are enabled
+     */
+    bool isLevelEnabled(LogLevel level) const {
+        uint8_t required = levelBit(level) | GLOBAL_ENABLED_BIT;
+        return (mLevelBits.load(std::memory_order_relaxed) & required) == required;
+    }
+    /**
+     * Enables or disables a single level, without affecting global enable
+     */
+    void setLevelEnabled(LogLevel level, bool value) {
+        if (value)
+            mLevelBits.fetch_or(levelBit(level), std::memory_order_relaxed);
+        else
+            mLevelBits.fetch_and(static_cast<uint8_t>(~levelBit(level)), std::memory_order_relaxed);
+        updateTagLevels();
+    }
+
+    /**
+     * @param level LogLevel
+     * @return Whether statements of this level are compiled in, see COMMONS_LOG_MIN_LEVEL
+     */
+    static constexpr bool isCompiled(LogLevel level) {
+        // written as > to avoid an always-true comparison warning for minimum 0
+        return static_cast<int>(level) + 1 > COMMONS_LOG_MIN_LEVEL;
     }
 
     /**
      * @return Currently registered loggers. Returns at least the default logger (see Log::defaultLogger())
      */
-    std::vector<ILogger *> loggers() {
+    const std::vector<ILogger *> &loggers() const {
         if (mLoggers.empty())
-            return {&mDefaultLogger};
+            return mDefaultLoggers;
         return mLoggers;
     }
 
@@ -226,6 +297,47 @@ public:
         return mDefaultLogger;
     }
 
+    /**
+     * Switches to asynchronous logging. Records are formatted on the logging thread and handed to a background worker,
+     * which is the only thread calling the loggers. Does nothing if already enabled.
+     *
+     * @param capacity Maximum number of records formatted or queued but not yet written
+     * @param policy Behavior if capacity is reached
+     */
+    void enableAsync(size_t capacity = 8192, AsyncFullPolicy policy = AsyncFullPolicy::Block);
+
+    /**
+     * Switches back to synchronous logging. Writes all pending records and stops the background worker.
+     */
+    void disableAsync();
+
+    /**
+     * @return True if asynchronous logging is enabled
+     */
+    bool isAsync() const {
+        return mAsync.load();
+    }
+
+    /**
+     * Waits until all records logged before have been written by the background worker and writes a pending
+     * repetition note, see setCollapseRepeats.
+     */
+    void flush();
+
+    /**
+     * Enables collapsing of repeated records. A record identical to the previous one at the same level is not
+     * written, but counted. The count is written as "Last message repeated K times" before the next different record
+     * or on flush(). Disabled by default.
+     */
+    void setCollapseRepeats(bool value);
+
+    /**
+     * @return Number of records discarded because the async queue was full
+     */
+    uint64_t droppedRecords() const {
+        return mAsyncDropped.load(std::memory_order_relaxed);
+    }
+
     /**
      * Trace log level
      */
@@ -254,18 +366,120 @@ public:
         return mInstance;
     }
 protected:
-    explicit Log() { }
+    explicit Log();
+    ~Log();
+
+    /**
+     * Decides how a new record is handled. Reserves a slot in the async queue if async logging is enabled.
+     */
+    RecordMode beginRecord();
+
+    /**
+     * Hands a formatted record to the async worker. Only valid after beginRecord returned RecordMode::Async.
+     */
+    void submitAsync(LogLevel level, std::string_view record, const LogRecordContext &context);
+
+    /**
+     * Writes a complete record to all loggers. Called on the logging thread or by the async worker.
+     */
+    void writeRecord(LogLevel level, std::string_view record, const LogRecordContext &context);
+
+    /**
+     * Passes the global level state to tags following it, see LogTagTable
+     */
+    void updateTagLevels();
+
+    /**
+     * Writes the note for collapsed repeats of the previous record, if any. Requires mLogLock.
+     */
+    void writeRepeats();
+
+    /**
+     * Waits until at most limit records are pending in the async queue
+     */
+    void waitPending(size_t limit);
+
+    /**
+     * @return Reusable buffer of the calling thread for formatting records
+     */
+    static LogRecordStream &recordBuffer() {
+        thread_local LogRecordStream buffer;
+        return buffer;
+    }
+
+    /**
+     * Resets the record buffer of the calling thread and writes the prefix of its logging context
+     *
+     * @return Size of the prefix
+     */
+    static size_t startRecord() {
+        auto &buffer = recordBuffer();
+        buffer.reset();
+
+        std::string_view prefix = LogContext::current().prefix();
+        buffer.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+        return prefix.size();
+    }
+
+    static constexpr uint8_t GLOBAL_ENABLED_BIT = 0x80;
+    static constexpr uint8_t levelBit(LogLevel level) {
+        return static_cast<uint8_t>(1u << static_cast<int>(level));
+    }
+    // bits of a level and all levels above
+    static constexpr uint8_t levelMask(LogLevel level) {
+        uint8_t bits = 0;
+        for (int l = static_cast<int>(level); l <= static_cast<int>(LogLevel::LEVEL_ERROR); l++)
+            bits |= levelBit(static_cast<LogLevel>(l));
+        return bits;
+    }
 
     std::vector<ILogger *> mLoggers;
+    // returned by loggers() if none are registered
+    std::vector<ILogger *> mDefaultLoggers {&mDefaultLogger};
 
-    bool mEnabled = true;
+    // one bit per enabled level and the global enable bit, all enabled by default
+    std::atomic<uint8_t> mLevelBits = ATOMIC_VAR_INIT(0xff);
     StdoutLogger mDefaultLogger;
     std::mutex mLogLock;
 
+    // repeat collapsing state, guarded by mLogLock
+    bool mCollapseRepeats = false;
+    LogLevel mLastLevel = LogLevel::VALUE_INVALID;
+    std::string mLastRecord;
+    uint64_t mRepeats = 0;
+
+    // async state
+    std::unique_ptr<AsyncLogWorker> mAsyncWorker;
+    std::mutex mAsyncLock;
+    std::atomic_bool mAsync = ATOMIC_VAR_INIT(false);
+    // records formatted or queued, but not written yet
+    std::atomic<size_t> mAsyncPending = ATOMIC_VAR_INIT(0);
+    std::atomic<uint64_t> mAsyncDropped = ATOMIC_VAR_INIT(0);
+    size_t mAsyncCapacity = 0;
+    AsyncFullPolicy mAsyncPolicy = AsyncFullPolicy::Block;
+
     static Log mInstance;
 
     template <LogLevel Level>
     friend class LogStream;
+    friend class AsyncLogWorker;
+    friend class LogTagTable;
 };
 
+/*
+ * Log statements that are removed at compile time if their level is below COMMONS_LOG_MIN_LEVEL, including the
+ * evaluation of all logged values. Used like the log streams: L_dbg << "value " << expensive();
+ * The discarded statements are still type-checked. Logged values are only evaluated if the level is enabled at
+ * runtime as well.
+ */
+#define L_log_internal(stream, level)                       \
+    if constexpr (!Log::isCompiled(LogLevel::level)) { }    \
+    else if (!Log::stream.isEnabled()) { }                  \
+    else Log::stream
+#define L_trac L_log_internal(trac, LEVEL_TRACE)
+#define L_dbg L_log_internal(dbg, LEVEL_DEBUG)
+#define L_info L_log_internal(info, LEVEL_INFO)
+#define L_warn L_log_internal(warn, LEVEL_WARNING)
+#define L_err L_log_internal(err, LEVEL_ERROR)
+
 #endif //COMMONS_LOG_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_LOGCONTEXT_H
+#define COMMONS_LOGCONTEXT_H
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Logging context of a thread (mapped diagnostic context): a stack of key-value pairs that is attached to every record
+ * logged on the thread, e.g. request or connection identifiers.
+ *
+ * Entries are pushed and popped with LogContext::Scope. The rendered prefix "[key=value key2=value2] " and the encoded
+ * fields are cached and only rebuilt after the context changed, so records cost a single copy of the prefix.
+ */
+class LogContext {
+public:
+    /**
+     * Pushes an entry to the context of the calling thread for its lifetime. Scopes must be destroyed in reverse
+     * order of creation on the thread that created them, which is implied by using them as local variables.
+     */
+    class Scope {
+    public:
+        /**
+         * @param key Field name, should consist of letters, digits and underscores to be usable as structured field
+         * @param value Field value, strings are used as is, other values are formatted with operator<<
+         */
+        template<typename T>
+        Scope(std::string_view key, const T &value) {
+            if constexpr (std::is_convertible_v<const T &, std::string_view>)
+                current().push(key, std::string(std::string_view(value)));
+            else if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+                current().push(key, std::to_string(value));
+            else {
+                std::stringstream bruce;
+                bruce << value;
+                current().push(key, bruce.str());
+            }
+        }
+        ~Scope() {
+            current().pop();
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    /**
+     * @return Context of the calling thread
+     */
+    static LogContext &current() {
+        thread_local LogContext context;
+        return context;
+    }
+
+    /**
+     * @return Number of entries
+     */
+    size_t size() const {
+        return mEntries.size();
+    }
+
+    /**
+     * @return Rendered prefix of all entries, empty if there are none
+     */
+    std::string_view prefix() {
+        update();
+        return mPrefix;
+    }
+
+    /**
+     * @return All entries encoded as key and value, each terminated by a null character. See forEachField.
+     */
+    std::string_view fields() {
+        update();
+        return mFields;
+    }
+
+    /**
+     * Calls fn(std::string_view key, std::string_view value) for every entry of encoded fields, outermost first
+     */
+    template<typename F>
+    static void forEachField(std::string_view fields, F &&fn) {
+        while (!fields.empty()) {
+            size_t keyEnd = fields.find('\0');
+            size_t valueEnd = fields.find('\0', keyEnd + 1);
+            if (keyEnd == std::string_view::npos || valueEnd == std::string_view::npos)
+                return;
+
+            fn(fields.substr(0, keyEnd), fields.substr(keyEnd + 1, valueEnd - keyEnd - 1));
+            fields.remove_prefix(valueEnd + 1);
+        }
+    }
+
+protected:
+    struct Entry {
+        std::string key;
+        std::string value;
+    };
+
+    void push(std::string_view key, std::string value) {
+        mEntries.push_back({std::string(key), std::move(value)});
+        mDirty = true;
+    }
+    void pop() {
+        if (!mEntries.empty())
+            mEntries.pop_back();
+        mDirty = true;
+    }
+
+    void update() {
+        if (!mDirty)
+            return;
+        mDirty = false;
+
+        mPrefix.clear();
+        mFields.clear();
+        for (const auto &entry : mEntries) {
+            mPrefix += mPrefix.empty() ? "[" : " ";
+            mPrefix.append(entry.key).append("=").append(entry.value);
+
+            mFields.append(entry.key).push_back('\0');
+            mFields.append(entry.value).push_back('\0');
+        }
+        if (!mPrefix.empty())
+            mPrefix += "] ";
+    }
+
+    std::vector<Entry> mEntries;
+    bool mDirty = false;
+    std::string mPrefix;
+    std::string mFields;
+};
+
+#endif //COMMONS_LOGCONTEXT_H
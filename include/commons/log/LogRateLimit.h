@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_LOGRATELIMIT_H
+#define COMMONS_LOGRATELIMIT_H
+
+#include <commons/log/Log.h>
+#include <commons/util/RateLimiter.h>
+
+#include <atomic>
+#include <ostream>
+
+/**
+ * Rate limit of a single log statement, see L_dbg_limit. Allows up to count records per interval and counts the
+ * suppressed ones, which are reported with the next record that passes. Checking is lock-free.
+ */
+class LogRateLimit {
+public:
+    /**
+     * Number of suppressed records, written as a note in front of a record if not zero
+     */
+    struct Suppressed {
+        uint64_t count;
+    };
+
+    /**
+     * @param count Records allowed per interval, also the burst size
+     * @param intervalMillis Interval in milliseconds
+     */
+    LogRateLimit(uint32_t count, int64_t intervalMillis)
+            : mLimiter(count * 1000.0 / static_cast<double>(intervalMillis), count) { }
+
+    /**
+     * @return True if a record may be logged, otherwise it is counted as suppressed
+     */
+    bool allow() {
+        if (mLimiter.tryAcquire())
+            return true;
+
+        mSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @return Records suppressed since the previous call
+     */
+    Suppressed takeSuppressed() {
+        // avoids the write in the common case of nothing suppressed
+        if (mSuppressed.load(std::memory_order_relaxed) == 0)
+            return {0};
+        return {mSuppressed.exchange(0, std::memory_order_relaxed)};
+    }
+
+    /**
+     * @return Records suppressed since the previous call to takeSuppressed, without resetting
+     */
+    uint64_t suppressed() const {
+        return mSuppressed.load(std::memory_order_relaxed);
+    }
+
+protected:
+    RateLimiter mLimiter;
+    std::atomic<uint64_t> mSuppressed = ATOMIC_VAR_INIT(0);
+};
+
+inline std::ostream &operator<<(std::ostream &os, LogRateLimit::Suppressed suppressed) {
+    if (suppressed.count > 0)
+        os << "(" << suppressed.count << " similar messages suppressed) ";
+    return os;
+}
+
+/*
+ * Rate-limited log statements, each call site writes at most count records per intervalMillis. Suppressed records
+ * are not formatted, their number is noted in the next record written by the same call site.
+ * Used like: L_dbg_limit(10, 1000) << "Connection failed: " << e.what();
+ */
+#define L_log_limit_internal(stream, level, count, intervalMillis)                                              \
+    if constexpr (!Log::isCompiled(LogLevel::level)) { }                                                        \
+    else if (!Log::stream.isEnabled()) { }                                                                      \
+    else if (static LogRateLimit _commons_rate_limit(count, intervalMillis); !_commons_rate_limit.allow()) { }  \
+    else Log::stream << _commons_rate_limit.takeSuppressed()
+#define L_trac_limit(count, intervalMillis) L_log_limit_internal(trac, LEVEL_TRACE, count, intervalMillis)
+#define L_dbg_limit(count, intervalMillis) L_log_limit_internal(dbg, LEVEL_DEBUG, count, intervalMillis)
+#define L_info_limit(count, intervalMillis) L_log_limit_internal(info, LEVEL_INFO, count, intervalMillis)
+#define L_warn_limit(count, intervalMillis) L_log_limit_internal(warn, LEVEL_WARNING, count, intervalMillis)
+#define L_err_limit(count, intervalMillis) L_log_limit_internal(err, LEVEL_ERROR, count, intervalMillis)
+
+#endif //COMMONS_LOGRATELIMIT_H
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_LOGRECORDSTREAM_H
+#define COMMONS_LOGRECORDSTREAM_H
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+/**
+ * Output stream formatting a log record into a growing buffer that is kept between records.
+ * Once the buffer has grown to the size of the longest record, formatting does not allocate anymore.
+ */
+class LogRecordStream : public std::ostream {
+    /**
+     * Stream buffer writing to a reusable vector
+     */
+    class RecordBuffer : public std::streambuf {
+    public:
+        RecordBuffer() : mData(256) {
+            reset();
+        }
+
+        void reset() {
+            setp(mData.data(), mData.data() + mData.size());
+        }
+
+        std::string_view view() const {
+            return {pbase(), static_cast<size_t>(pptr() - pbase())};
+        }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (traits_type::eq_int_type(ch, traits_type::eof()))
+                return traits_type::not_eof(ch);
+
+            grow(1);
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+            return ch;
+        }
+
+        std::streamsize xsputn(const char *s, std::streamsize n) override {
+            if (epptr() - pptr() < n)
+                grow(static_cast<size_t>(n));
+
+            std::memcpy(pptr(), s, static_cast<size_t>(n));
+            pbump(static_cast<int>(n));
+            return n;
+        }
+
+        void grow(size_t required) {
+            size_t used = static_cast<size_t>(pptr() - pbase());
+            mData.resize(std::max(mData.size() * 2, used + required));
+
+            setp(mData.data(), mData.data() + mData.size());
+            pbump(static_cast<int>(used));
+        }
+
+        std::vector<char> mData;
+    };
+
+public:
+    LogRecordStream() : std::ostream(nullptr) {
+        rdbuf(&mBuffer);
+    }
+
+    /**
+     * Starts a new record. Discards the previous contents and restores default formatting.
+     */
+    void reset() {
+        mBuffer.reset();
+        clear();
+        flags(std::ios_base::dec | std::ios_base::skipws);
+        precision(6);
+        width(0);
+        fill(' ');
+    }
+
+    /**
+     * @return Contents of the current record, valid until the next write or reset
+     */
+    std::string_view view() const {
+        return mBuffer.view();
+    }
+
+protected:
+    RecordBuffer mBuffer;
+};
+
+#endif //COMMONS_LOGRECORDSTREAM_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_LOGTAG_H
+#define COMMONS_LOGTAG_H
+
+#include <commons/log/Log.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Declares a component tag for tagged log statements, e.g. COMMONS_LOG_TAG(network); at namespace scope, used as
+ * L_dbg_tag(network) << "Connected";
+ */
+#define COMMONS_LOG_TAG(tag)                        \
+    struct LogTag_##tag {                           \
+        static constexpr const char *name = #tag;   \
+    }
+
+/**
+ * Level table of component tags. Each tag has a byte of level bits in the same format as Log, so that checking a
+ * tagged log statement is a single relaxed atomic load.
+ *
+ * Tags follow the global levels of Log unless a level is set for them. Global enable applies to all tags. The table
+ * can be reconfigured at any time from any thread, e.g. on a configuration reload. Tags can be configured by name
+ * before their first log statement ran.
+ */
+class LogTagTable {
+public:
+    // tags beyond this share one entry that always follows the global levels
+    static constexpr size_t MAX_TAGS = 64;
+
+    /**
+     * @return Process-wide tag table, created on first use
+     */
+    static LogTagTable &get() {
+        static LogTagTable instance;
+        return instance;
+    }
+
+    /**
+     * @tparam Tag Tag declared with COMMONS_LOG_TAG
+     * @param level LogLevel
+     * @return Whether statements of this tag and level are logged
+     */
+    template<typename Tag>
+    static bool isEnabled(LogLevel level) {
+        // resolved once per tag, safe to use during static initialization
+        static std::atomic<uint8_t> &bits = get().registerTag(Tag::name);
+
+        uint8_t required = Log::levelBit(level) | Log::GLOBAL_ENABLED_BIT;
+        return (bits.load(std::memory_order_relaxed) & required) == required;
+    }
+
+    /**
+     * Sets the minimum level of a tag, overriding the global levels. LogLevel::VALUE_INVALID disables the tag.
+     */
+    void setLevel(std::string_view tag, LogLevel level);
+
+    /**
+     * Lets a tag follow the global levels again
+     */
+    void resetLevel(std::string_view tag);
+
+    /**
+     * Lets all tags follow the global levels again
+     */
+    void resetAll();
+
+    /**
+     * @return Names of all known tags
+     */
+    std::vector<std::string> tags() const;
+
+    /**
+     * Returns the level bits of a tag, adding it if unknown
+     */
+    std::atomic<uint8_t> &registerTag(std::string_view tag);
+
+    /**
+     * Applies the global level bits of Log. Called by Log on every level change.
+     */
+    void setGlobal(const std::atomic<uint8_t> &bits);
+
+protected:
+    struct Entry {
+        std::string name;
+        bool overridden = false;
+        uint8_t levelBits = 0;
+    };
+
+    LogTagTable();
+
+    // requires mMutex
+    size_t findOrAdd(std::string_view tag);
+    void apply(size_t index);
+
+    mutable std::mutex mMutex;
+    std::vector<Entry> mEntries;
+    uint8_t mGlobalBits = 0xff;
+    // one byte per tag plus the shared overflow entry
+    std::array<std::atomic<uint8_t>, MAX_TAGS + 1> mBits;
+};
+
+/*
+ * Tagged log statements, filtered by the levels of their tag in LogTagTable instead of the global levels.
+ * The record is prefixed with the tag name. Levels below COMMONS_LOG_MIN_LEVEL are removed at compile time.
+ */
+#define L_log_tag_internal(tag, stream, level)                                  \
+    if constexpr (!Log::isCompiled(LogLevel::level)) { }                        \
+    else if (!LogTagTable::isEnabled<LogTag_##tag>(LogLevel::level)) { }        \
+    else Log::stream.unchecked() << "[" #tag "] "
+#define L_trac_tag(tag) L_log_tag_internal(tag, trac, LEVEL_TRACE)
+#define L_dbg_tag(tag) L_log_tag_internal(tag, dbg, LEVEL_DEBUG)
+#define L_info_tag(tag) L_log_tag_internal(tag, info, LEVEL_INFO)
+#define L_warn_tag(tag) L_log_tag_internal(tag, warn, LEVEL_WARNING)
+#define L_err_tag(tag) L_log_tag_internal(tag, err, LEVEL_ERROR)
+
+#endif //COMMONS_LOGTAG_H
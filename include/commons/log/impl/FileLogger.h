@@ -39,6 +39,15 @@ public:
 
     bool wantsLog(LogLevel level) override;
 
+    /**
+     * Writes the prefix of a record as written to the log file
+     *
+     * @param os Output stream
+     * @param timestamp Milliseconds since epoch, formatted in local time
+     * @param level LogLevel of the record
+     */
+    static void writePrefix(std::ostream &os, int64_t timestamp, LogLevel level);
+
 protected:
     std::ofstream mFile;
 };
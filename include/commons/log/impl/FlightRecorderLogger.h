@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_FLIGHTRECORDERLOGGER_H
+#define COMMONS_FLIGHTRECORDERLOGGER_H
+
+#include <commons/log/ILogger.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * This ILogger implementation records all log levels into a fixed-size memory-mapped file used as a circular buffer.
+ *
+ * Writers reserve space with a single atomic add and commit a record by storing its position last, so no locks are
+ * taken and records of a crashed process survive in the page cache without any flush. Older records are overwritten
+ * once the buffer is full. Use FlightRecorderReader to extract the most recent records.
+ *
+ * Only available on POSIX platforms, open() fails elsewhere.
+ */
+class FlightRecorderLogger : public ILogger {
+public:
+    /**
+     * File layout. All values in native byte order, the data area follows the header.
+     *
+     * Records start at positions aligned to 8 bytes, positions count bytes ever reserved and map into the data area
+     * modulo its capacity. A record is valid if its header contains its own position, so stale data and records whose
+     * writer crashed before committing are detected.
+     */
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t capacity;
+        // next free position, accessed atomically
+        uint64_t writePos;
+        char reserved[32];
+    };
+    struct RecordHeader {
+        // own position, written last
+        uint64_t pos;
+        // total size including this header, multiple of 8
+        uint32_t size;
+        uint8_t level;
+        // bytes of padding after the text
+        uint8_t padding;
+        uint8_t reserved[2];
+        int64_t timestamp;
+    };
+    static constexpr char MAGIC[8] = {'V', 'D', 'F', 'L', 'I', 'G', 'H', 'T'};
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * Opens or creates the file. Records of a previous run are kept if the capacity matches.
+     *
+     * @param filename Backing file
+     * @param capacity Size of the data area in bytes, rounded up to a power of two of at least 4096
+     */
+    explicit FlightRecorderLogger(std::string filename, size_t capacity = 16 * 1024 * 1024);
+    ~FlightRecorderLogger() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() override;
+
+    /**
+     * Records are passed to write() directly, values written to this stream are discarded
+     */
+    std::ostream &stream() override {
+        return mNullStream;
+    }
+
+    /**
+     * Records a record. Thread-safe and lock-free. Records longer than a quarter of the capacity are truncated.
+     * A writer that is overtaken by others wrapping around the whole buffer loses its record.
+     */
+    void write(std::string_view record, LogLevel level) override;
+
+protected:
+    void copyIn(uint64_t pos, const void *data, size_t size);
+
+    std::string mFilename;
+    size_t mCapacity;
+
+    int mFd = -1;
+    char *mMap = nullptr;
+    size_t mMapSize = 0;
+    char *mData = nullptr;
+    std::atomic<uint64_t> *mWritePos = nullptr;
+
+    std::ostream mNullStream {nullptr};
+};
+
+/**
+ * Extracts records from flight recorder files
+ */
+class FlightRecorderReader {
+public:
+    /**
+     * Writes the most recent records in order, in the format FileLogger would have written them
+     *
+     * @param filename Flight recorder file
+     * @param out Text output
+     * @param maxRecords Maximum number of most recent records to write, 0 writes all available records
+     * @return False if the file cannot be read or is no flight recorder file
+     */
+    static bool read(const std::string &filename, std::ostream &out, size_t maxRecords = 0);
+};
+
+#endif //COMMONS_FLIGHTRECORDERLOGGER_H
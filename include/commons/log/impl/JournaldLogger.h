@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_JOURNALDLOGGER_H
+#define COMMONS_JOURNALDLOGGER_H
+
+#include <commons/log/ILogger.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * This ILogger implementation sends all log levels to journald using its native protocol, without going through
+ * stdout. Each record becomes a journal entry with the fields PRIORITY, SYSLOG_IDENTIFIER, TID and MESSAGE.
+ * Entries of the LogContext are added as fields with upper case names, MESSAGE is written without context prefix.
+ * TID is the thread calling write, which is the async worker if Log::enableAsync is used.
+ *
+ * The protocol allows one entry per datagram. Entries are collected in user space and sent once maxBatch entries are
+ * collected, after flushIntervalMillis or on flush(), using a single sendmmsg call per batch on Linux.
+ *
+ * Not available on Windows, open() fails there.
+ */
+class JournaldLogger : public ILogger {
+public:
+    struct Config {
+        // journald socket, can be replaced for testing
+        std::string socketPath = "/run/systemd/journal/socket";
+        // SYSLOG_IDENTIFIER field, omitted if empty
+        std::string identifier;
+        // entries sent with a single system call
+        size_t maxBatch = 32;
+        // send collected entries at least in this interval, 0 sends only full batches or on flush
+        int64_t flushIntervalMillis = 100;
+    };
+
+    JournaldLogger();
+    explicit JournaldLogger(Config config);
+    ~JournaldLogger() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() override;
+
+    /**
+     * Sends all collected entries
+     */
+    void flush() override;
+
+    /**
+     * Records are passed to write() directly, values written to this stream are discarded
+     */
+    std::ostream &stream() override {
+        return mNullStream;
+    }
+
+    void write(std::string_view record, LogLevel level) override;
+    void writeWithContext(std::string_view record, LogLevel level, const LogRecordContext &context) override;
+
+    /**
+     * @return Number of entries that could not be sent
+     */
+    uint64_t failedEntries() const {
+        return mFailed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Appends a field in journal export format to an entry. Values containing a newline use the binary form.
+     */
+    static void appendField(std::string &entry, std::string_view name, std::string_view value);
+
+protected:
+    // requires mMutex
+    bool connectSocket();
+    void sendBatch();
+
+    void flushEntry();
+
+    Config mConfig;
+    int mFd = -1;
+
+    std::mutex mMutex;
+    // entries are reused to keep their capacity
+    std::vector<std::string> mBatch;
+    size_t mBatchSize = 0;
+    std::string mFieldName;
+    std::atomic<uint64_t> mFailed = ATOMIC_VAR_INIT(0);
+
+    // periodic flush
+    std::condition_variable mFlushCond;
+    std::thread mFlushThread;
+    bool mStopped = false;
+
+    std::ostream mNullStream {nullptr};
+};
+
+#endif //COMMONS_JOURNALDLOGGER_H
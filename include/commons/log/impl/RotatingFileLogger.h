@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_ROTATINGFILELOGGER_H
+#define COMMONS_ROTATINGFILELOGGER_H
+
+#include <commons/log/ILogger.h>
+#include <commons/log/LogRecordStream.h>
+#include <commons/thread/IQueueWorker.h>
+#include <commons/thread/Queue.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * This ILogger implementation logs all log levels to a file that is rotated by size and age.
+ *
+ * Records are collected in a user-space buffer, which is written to the file when it exceeds a byte threshold or
+ * after a flush interval. Rotated files are named <filename>.1 (newest) to <filename>.<keepFiles> and optionally
+ * compressed to <filename>.<n>.gz on a background thread, if Commons was built with zlib. Files failing to compress
+ * are kept uncompressed as <filename>.<n> and shifted like the others.
+ *
+ * If the file cannot be reopened after rotation, records are dropped and reopening is retried on later writes and
+ * flushes. The number of dropped records is written to the file once it is open again.
+ */
+class RotatingFileLogger : public ILogger {
+public:
+    /**
+     * When the file is synced to disk using fdatasync
+     */
+    enum class SyncPolicy {
+        None,       /**< Never, the OS decides **/
+        Flush,      /**< After every write of the buffer **/
+        Rotate,     /**< Before the file is rotated **/
+    };
+
+    struct Config {
+        // rotate once the file reaches this size, 0 disables
+        size_t maxBytes = 64 * 1024 * 1024;
+        // rotate once the file is open for this long, 0 disables
+        int64_t maxAgeMillis = 0;
+        // number of rotated files to keep
+        size_t keepFiles = 5;
+        // write the buffer to the file once it holds this many bytes
+        size_t bufferBytes = 256 * 1024;
+        // write the buffer at least in this interval, 0 writes only if bufferBytes is reached or on flush
+        int64_t flushIntervalMillis = 1000;
+        SyncPolicy sync = SyncPolicy::None;
+        // gzip rotated files in background, ignored without zlib support
+        bool compress = false;
+        // retry reopening the file in this interval if it failed after rotation
+        int64_t reopenIntervalMillis = 1000;
+    };
+
+    /**
+     * Opens the file for appending
+     *
+     * @param filename File to write, rotated files are stored next to it
+     * @param config Rotation and buffering settings
+     */
+    RotatingFileLogger(std::string filename, Config config);
+    explicit RotatingFileLogger(std::string filename);
+    ~RotatingFileLogger() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() override;
+
+    /**
+     * Writes the buffer to the file
+     */
+    void flush() override;
+
+    /**
+     * Stream writing to the buffer without prefix or locking. Use Log instead.
+     */
+    std::ostream &stream() override {
+        return mBuffer;
+    }
+
+    void write(std::string_view record, LogLevel level) override;
+
+    /**
+     * Rotates the file now, regardless of size and age
+     */
+    void rotate();
+
+    /**
+     * @return True if rotated files can be compressed
+     */
+    static bool compressionSupported();
+
+    /**
+     * @return Path of the rotated file with given index, including ".gz" if compression is enabled and supported
+     */
+    std::string rotatedName(size_t index) const;
+
+protected:
+    /**
+     * Compresses rotated files and shifts them by one index, so that file renames never race with compression
+     */
+    class RotateWorker : public IQueueWorker<std::string> {
+    public:
+        explicit RotateWorker(RotatingFileLogger &logger)
+                : IQueueWorker(new Queue<std::string>(), "log rotation"), mLogger(logger) { }
+        ~RotateWorker() override {
+            // stop before vtable of this class is gone
+            stopThread();
+        }
+
+        /**
+         * Processes rotations left in the queue on the calling thread. Only valid after the thread has been stopped.
+         */
+        void drain() {
+            std::string pending;
+            while (mQueue->pop(pending))
+                doWork(pending);
+        }
+
+    protected:
+        void doWork(const std::string &pending) override {
+            if (!pending.empty())
+                mLogger.shiftRotated(pending);
+        }
+
+        RotatingFileLogger &mLogger;
+    };
+
+    // requires mMutex
+    bool openFile();
+    // reopens the file after a failed rotation, at most once per reopenIntervalMillis unless forced
+    bool reopenFile(bool force);
+    void closeFile();
+    void writeBuffer();
+    void rotateFile();
+
+    // moves rotated files up by one index, deletes the oldest and moves pending to index 1
+    void shiftRotated(const std::string &pending);
+    // path of the rotated file with given index if it could not be compressed
+    std::string uncompressedName(size_t index) const;
+
+    void flushEntry();
+
+    std::string mFilename;
+    Config mConfig;
+
+    std::mutex mMutex;
+    std::FILE *mFile = nullptr;
+    LogRecordStream mBuffer;
+    size_t mFileBytes = 0;
+    int64_t mOpenedAt = 0;
+    uint64_t mRotations = 0;
+
+    // set if the file failed to reopen after rotation
+    bool mReopen = false;
+    int64_t mReopenAt = 0;
+    uint64_t mDropped = 0;
+
+    // periodic flush
+    std::condition_variable mFlushCond;
+    std::thread mFlushThread;
+    bool mStopped = false;
+
+    std::unique_ptr<RotateWorker> mRotateWorker;
+};
+
+#endif //COMMONS_ROTATINGFILELOGGER_H
@@ -49,7 +49,7 @@ public:
         return true;
     }
 
-    SystemdLogLevel toSystemdLevel(LogLevel level) {
+    static SystemdLogLevel toSystemdLevel(LogLevel level) {
         switch (level) {
             case LogLevel::LEVEL_TRACE:
                 return SystemdLogLevel::DEBUG;
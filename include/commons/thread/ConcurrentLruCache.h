@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_CONCURRENTLRUCACHE_H
+#define COMMONS_CONCURRENTLRUCACHE_H
+
+#include <commons/util/Timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Thread-safe key-value cache with bounded size or weight and optional per-entry time to live.
+ *
+ * Keys are distributed by hash across independently locked shards. Eviction is approximate LRU using the CLOCK
+ * algorithm: a lookup only sets the entry's reference bit under a shared lock, so concurrent reads never contend on a
+ * recency list. Each shard owns an equal part of the total capacity.
+ *
+ * @tparam K Key type, must be hashable by Hash and comparable by KeyEqual
+ * @tparam V Value type, returned by copy
+ */
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class ConcurrentLruCache {
+public:
+    /// Computes the weight of an entry, must not be 0
+    using Weigher_t = std::function<size_t(const K &, const V &)>;
+
+    /**
+     * Constructs a new cache
+     *
+     * @param capacity Maximum total weight of all entries. Without weigher, this is the maximum number of entries.
+     * @param ttlMillis Default time to live of entries in milliseconds, 0 for indefinite
+     * @param shardCount Number of shards, rounded up to the next power of two not exceeding capacity
+     * @param weigher Optional weight function, defaults to weight 1 per entry
+     */
+    explicit ConcurrentLruCache(size_t capacity, int64_t ttlMillis = 0, size_t shardCount = 16,
+                                Weigher_t weigher = {})
+            : mTtlMillis(ttlMillis), mWeigher(std::move(weigher)) {
+        // round shard count up to power of two, but never exceed capacity
+        size_t count = 1;
+        while (count < shardCount && count * 2 <= std::max<size_t>(capacity, 1))
+            count *= 2;
+
+        mShardMask = count - 1;
+        mShards = std::make_unique<Shard[]>(count);
+
+        // distribute capacity, rounding up so the total is never below the requested capacity
+        for (size_t i = 0; i < count; i++)
+            mShards[i].capacity = (capacity + count - 1) / count;
+    }
+
+    /**
+     * Inserts or replaces the value for key
+     *
+     * @param key Entry key
+     * @param value Entry value
+     * @param ttlMillis Time to live in milliseconds, 0 for indefinite. Uses the cache default if not set.
+     * @return False if the entry's weight exceeds the capacity of a shard and could therefore not be inserted
+     */
+    bool put(const K &key, V value, std::optional<int64_t> ttlMillis = std::nullopt) {
+        size_t weight = mWeigher ? mWeigher(key, value) : 1;
+        Shard &shard = shardFor(key);
+        if (weight > shard.capacity)
+            return false;
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        // replace existing entry in place
+        if (auto it = shard.index.find(key); it != shard.index.end()) {
+            Node *node = it->second;
+            shard.weight -= node->weight;
+            node->value = std::move(value);
+            node->weight = weight;
+            node->expiry = makeExpiry(ttlMillis);
+            node->referenced.store(true, std::memory_order_relaxed);
+            shard.weight += weight;
+
+            // make room for a grown entry among the other entries
+            while (shard.weight > shard.capacity)
+                evictOne(shard, node);
+        }
+        else {
+            // make room before insert, so the sweep can never pick the new entry
+            while (shard.weight + weight > shard.capacity)
+                evictOne(shard);
+
+            auto node = std::make_unique<Node>(key, std::move(value), weight, makeExpiry(ttlMillis));
+            node->slot = shard.ring.size();
+            shard.index.emplace(node->key, node.get());
+            shard.ring.push_back(std::move(node));
+            shard.weight += weight;
+        }
+
+        return true;
+    }
+
+    /**
+     * Looks up the value for key. Expired entries are reported as missing.
+     *
+     * @param key Entry key
+     * @return Copy of the value if found
+     */
+    std::optional<V> get(const K &key) {
+        Shard &shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it == shard.index.end() || it->second->expiry.elapsed()) {
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+
+        // only write the reference bit if it changes to keep the cache line shared between readers
+        Node *node = it->second;
+        if (!node->referenced.load(std::memory_order_relaxed))
+            node->referenced.store(true, std::memory_order_relaxed);
+
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        return node->value;
+    }
+
+    /**
+     * Removes the entry for key
+     *
+     * @param key Entry key
+     * @return True if an entry was removed
+     */
+    bool erase(const K &key) {
+        Shard &shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+            return false;
+
+        removeAt(shard, it->second->slot);
+        return true;
+    }
+
+    /// Removes all entries. Does not reset the statistic counters.
+    void clear() {
+        for (size_t i = 0; i <= mShardMask; i++) {
+            Shard &shard = mShards[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+            shard.index.clear();
+            shard.ring.clear();
+            shard.hand = 0;
+            shard.weight = 0;
+        }
+    }
+
+    /// @return Number of entries, including expired ones not evicted yet
+    size_t size() const {
+        return accumulate([] (const Shard &shard) { return shard.ring.size(); });
+    }
+
+    /// @return Total weight of all entries
+    size_t weight() const {
+        return accumulate([] (const Shard &shard) { return shard.weight; });
+    }
+
+    /// @return Number of lookups that found a valid entry
+    uint64_t hits() const {
+        return accumulate([] (const Shard &shard) { return shard.hits.load(std::memory_order_relaxed); });
+    }
+
+    /// @return Number of lookups that found no or an expired entry
+    uint64_t misses() const {
+        return accumulate([] (const Shard &shard) { return shard.misses.load(std::memory_order_relaxed); });
+    }
+
+    /// @return Number of entries removed to make room or because they expired
+    uint64_t evictions() const {
+        return accumulate([] (const Shard &shard) { return shard.evictions.load(std::memory_order_relaxed); });
+    }
+
+    /// @return Number of shards
+    size_t shardCount() const {
+        return mShardMask + 1;
+    }
+
+protected:
+    struct Node {
+        Node(const K &_key, V _value, size_t _weight, Timer _expiry)
+                : key(_key), value(std::move(_value)), weight(_weight), expiry(_expiry) { }
+
+        K key;
+        V value;
+        size_t weight;
+        // index in the clock ring
+        size_t slot = 0;
+        // inactive timer if entry does not expire
+        Timer expiry;
+        // CLOCK reference bit, set by readers
+        std::atomic_bool referenced = ATOMIC_VAR_INIT(false);
+    };
+
+    // aligned to avoid false sharing of locks and counters between shards
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        // lookup of ring nodes, keys are owned by the nodes
+        std::unordered_map<std::reference_wrapper<const K>, Node *, Hash, KeyEqual> index;
+        // clock ring
+        std::vector<std::unique_ptr<Node>> ring;
+        size_t hand = 0;
+
+        size_t capacity = 0;
+        size_t weight = 0;
+
+        std::atomic<uint64_t> hits = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> misses = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> evictions = ATOMIC_VAR_INIT(0);
+    };
+
+    Shard &shardFor(const K &key) const {
+        // fibonacci hashing to spread weak hashes, use the high bits that the shard's map does not rely on
+        uint64_t h = static_cast<uint64_t>(Hash()(key)) * 0x9e3779b97f4a7c15ull;
+        return mShards[(h >> 32) & mShardMask];
+    }
+
+    Timer makeExpiry(const std::optional<int64_t> &ttlMillis) const {
+        int64_t ttl = ttlMillis.value_or(mTtlMillis);
+        return ttl > 0 ? Timer(Timer::begin::now, ttl) : Timer();
+    }
+
+    // advances the clock hand until an expired or unreferenced entry other than keep is found and removes it
+    static void evictOne(Shard &shard, const Node *keep = nullptr) {
+        while (shard.ring.size() > (keep ? 1u : 0u)) {
+            if (shard.hand >= shard.ring.size())
+                shard.hand = 0;
+
+            Node *node = shard.ring[shard.hand].get();
+            if (node != keep
+                    && (node->expiry.elapsed() || !node->referenced.exchange(false, std::memory_order_relaxed))) {
+                removeAt(shard, shard.hand);
+                shard.evictions.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // second chance
+            shard.hand++;
+        }
+    }
+
+    // removes ring slot i by moving the last slot into it
+    static void removeAt(Shard &shard, size_t i) {
+        shard.weight -= shard.ring[i]->weight;
+        shard.index.erase(shard.ring[i]->key);
+
+        if (i + 1 != shard.ring.size()) {
+            shard.ring[i] = std::move(shard.ring.back());
+            shard.ring[i]->slot = i;
+        }
+        shard.ring.pop_back();
+    }
+
+    template<typename F>
+    uint64_t accumulate(F fun) const {
+        uint64_t result = 0;
+        for (size_t i = 0; i <= mShardMask; i++) {
+            std::shared_lock<std::shared_mutex> lock(mShards[i].mutex);
+            result += fun(mShards[i]);
+        }
+        return result;
+    }
+
+    size_t mShardMask = 0;
+    std::unique_ptr<Shard[]> mShards;
+
+    int64_t mTtlMillis;
+    Weigher_t mWeigher;
+};
+
+#endif //COMMONS_CONCURRENTLRUCACHE_H
@@ -20,6 +20,7 @@
 #define COMMONS_QUEUEWORKER_H
 
 #include <commons/thread/IQueue.h>
+#include <commons/thread/WorkerStatus.h>
 #include <thread>
 
 /**
@@ -28,7 +29,7 @@
  * @tparam W Type of work in the queue
  */
 template <typename W>
-class IQueueWorker {
+class IQueueWorker : public WorkerStatus {
 public:
     /**
      * Constructs new QueueWorker
@@ -38,6 +39,14 @@ public:
     template <template<class> class Q>
     explicit IQueueWorker(Q<W> *queue) : mQueue(queue) { }
 
+    /**
+     * Constructs new QueueWorker with a name used in status reports
+     *
+     * @tparam Q Type of message queue implementation
+     */
+    template <template<class> class Q>
+    IQueueWorker(Q<W> *queue, std::string name) : WorkerStatus(std::move(name)), mQueue(queue) { }
+
     /**
      * Move constructor
      */
@@ -82,7 +91,7 @@ public:
         mQueue->push(work);
     }
     void enqueue(W &&work) {
-        mQueue->push(work);
+        mQueue->push(std::move(work));
     }
 
     /**
@@ -90,7 +99,7 @@ public:
      *
      * @return Approximate queue size
      */
-    size_t sizeApprox() {
+    size_t sizeApprox() override {
         return mQueue->sizeApprox();
     }
 
@@ -100,15 +109,19 @@ protected:
      */
     virtual void threadEntry() {
         // some impls require per-thread init
+        beginThread();
         initThread();
 
         W value;
         while (mQueue->pop_wait(value)) {
+            beginWork();
             doWork(value);
+            endWork();
         }
 
         // some impls require per-thread resources release
         releaseThread();
+        endThread();
     }
 
     // optional per-thread platform initialization
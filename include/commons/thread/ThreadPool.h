@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_THREADPOOL_H
+#define COMMONS_THREADPOOL_H
+
+#include <commons/thread/IQueueWorker.h>
+#include <commons/thread/Queue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Fixed number of queue workers executing tasks, with helpers for chunked data-parallel loops
+ */
+class ThreadPool {
+public:
+    using Task_t = std::function<void()>;
+
+    /**
+     * Creates a pool and starts its worker threads
+     *
+     * @param threads Number of worker threads. With 0 threads, all parallel helpers run on the calling thread.
+     */
+    explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+        mWorkers.reserve(threads);
+        for (size_t i = 0; i < threads; i++) {
+            mWorkers.emplace_back(std::make_unique<Worker>());
+            mWorkers.back()->startThread();
+        }
+    }
+
+    /**
+     * Stops all workers. Tasks not started yet are discarded.
+     */
+    ~ThreadPool() {
+        for (auto &worker : mWorkers)
+            worker->stopThread();
+    }
+
+    /**
+     * Enqueues a task to one of the workers in round-robin order
+     *
+     * @param task Task to execute, must not throw
+     */
+    void submit(Task_t task) {
+        if (mWorkers.empty()) {
+            task();
+            return;
+        }
+
+        size_t index = mNext.fetch_add(1, std::memory_order_relaxed) % mWorkers.size();
+        mWorkers[index]->enqueue(std::move(task));
+    }
+
+    /// @return Number of worker threads
+    size_t size() const {
+        return mWorkers.size();
+    }
+
+    /**
+     * Calls fn(i) for every i in [begin, end). The range is split into chunks of grain indices that are claimed
+     * dynamically by the calling thread and up to size() workers. A range of at most one chunk is processed on the
+     * calling thread only. The calling thread blocks until all chunks are done.
+     *
+     * @param begin First index
+     * @param end Index past the last index
+     * @param grain Number of indices per chunk, treated as 1 if 0
+     * @param fn Function to call for each index. The first exception thrown is rethrown after all chunks settled,
+     * chunks not started yet are skipped.
+     */
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F &&fn) {
+        runChunked(begin, end, grain, [&fn] (size_t, size_t chunkBegin, size_t chunkEnd) {
+            for (size_t i = chunkBegin; i < chunkEnd; i++)
+                fn(i);
+        });
+    }
+
+    /**
+     * Folds every i in [begin, end) into a value. Chunks are scheduled as in parallelFor, each chunk folds its indices
+     * starting at identity using fn(acc, i), then chunk results are combined in index order on the calling thread.
+     *
+     * @param begin First index
+     * @param end Index past the last index
+     * @param grain Number of indices per chunk, treated as 1 if 0
+     * @param identity Initial value of every chunk and the result for an empty range
+     * @param fn Fold function T(T acc, size_t i)
+     * @param reduce Combine function T(T a, T b), must be associative
+     * @return Combined value of all chunks
+     */
+    template<typename T, typename F, typename R>
+    T parallelReduce(size_t begin, size_t end, size_t grain, const T &identity, F &&fn, R &&reduce) {
+        size_t chunks = chunkCount(begin, end, grain);
+        std::vector<T> partials(chunks, identity);
+
+        runChunked(begin, end, grain, [&fn, &partials] (size_t chunk, size_t chunkBegin, size_t chunkEnd) {
+            T acc = std::move(partials[chunk]);
+            for (size_t i = chunkBegin; i < chunkEnd; i++)
+                acc = fn(std::move(acc), i);
+            partials[chunk] = std::move(acc);
+        });
+
+        T result = identity;
+        for (auto &partial : partials)
+            result = reduce(std::move(result), std::move(partial));
+        return result;
+    }
+
+    /**
+     * @return Process-wide pool with one worker per hardware thread, created on first use
+     */
+    static ThreadPool &get() {
+        static ThreadPool instance;
+        return instance;
+    }
+
+protected:
+    class Worker : public IQueueWorker<Task_t> {
+    public:
+        Worker() : IQueueWorker(new Queue<Task_t>()) { }
+        ~Worker() override {
+            // stop before vtable of this class is gone
+            stopThread();
+        }
+
+    protected:
+        void doWork(const Task_t &task) override {
+            if (task)
+                task();
+        }
+    };
+
+    // shared between the caller and helper tasks, which may outlive the call if they start late
+    struct ChunkState {
+        std::atomic<size_t> next = ATOMIC_VAR_INIT(0);
+        std::atomic<size_t> done = ATOMIC_VAR_INIT(0);
+        std::atomic_bool failed = ATOMIC_VAR_INIT(false);
+        std::exception_ptr error;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+    };
+
+    static size_t chunkCount(size_t begin, size_t end, size_t &grain) {
+        if (grain == 0)
+            grain = 1;
+        return end > begin ? (end - begin + grain - 1) / grain : 0;
+    }
+
+    template<typename C>
+    void runChunked(size_t begin, size_t end, size_t grain, const C &chunkFn) {
+        size_t chunks = chunkCount(begin, end, grain);
+
+        // small range or no workers: run on calling thread, exceptions propagate directly
+        if (chunks <= 1 || mWorkers.empty()) {
+            for (size_t chunk = 0; chunk < chunks; chunk++)
+                chunkFn(chunk, begin + chunk * grain, std::min(end, begin + (chunk + 1) * grain));
+            return;
+        }
+
+        auto state = std::make_shared<ChunkState>();
+        // chunkFn is only dereferenced for claimed chunks, all of which complete before the caller returns
+        auto work = [state, &chunkFn, chunks, begin, end, grain] () {
+            for (size_t chunk; (chunk = state->next.fetch_add(1)) < chunks; ) {
+                if (!state->failed.load(std::memory_order_relaxed)) {
+                    try {
+                        chunkFn(chunk, begin + chunk * grain, std::min(end, begin + (chunk + 1) * grain));
+                    }
+                    catch (...) {
+                        std::unique_lock<std::mutex> lock(state->mutex);
+                        if (!state->error)
+                            state->error = std::current_exception();
+                        state->failed.store(true);
+                    }
+                }
+
+                if (state->done.fetch_add(1) + 1 == chunks) {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->cond.notify_all();
+                }
+            }
+        };
+
+        // helpers beyond the number of chunks would find nothing to do
+        size_t helpers = std::min(mWorkers.size(), chunks - 1);
+        for (size_t i = 0; i < helpers; i++)
+            submit(work);
+
+        // calling thread takes part, so progress never depends on busy workers
+        work();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cond.wait(lock, [&] () { return state->done.load() == chunks; });
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::atomic<size_t> mNext = ATOMIC_VAR_INIT(0);
+};
+
+#endif //COMMONS_THREADPOOL_H
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_WORKERSTATUS_H
+#define COMMONS_WORKERSTATUS_H
+
+#include <commons/util/Timer.h>
+
+#include <atomic>
+#include <string>
+
+#ifndef WIN32
+    #include <pthread.h>
+    #include <ctime>
+#endif
+
+/**
+ * Type-independent state of a worker thread that can be observed from other threads, e.g. by a WorkerWatchdog.
+ * All accessors are thread-safe.
+ */
+class WorkerStatus {
+public:
+    explicit WorkerStatus(std::string name = "worker") : mName(std::move(name)) { }
+
+    /**
+     * Move constructor, moves name and watch flag. Must not be used while the worker thread is running.
+     */
+    WorkerStatus(WorkerStatus &&other) noexcept : mName(std::move(other.mName)),
+            mWatched(other.mWatched.load()) { }
+
+    virtual ~WorkerStatus() = default;
+
+    /// @return Name of the worker used in reports
+    const std::string &name() const {
+        return mName;
+    }
+    /// Sets the name of the worker. Must not be called while watched.
+    void name(const std::string &value) {
+        mName = value;
+    }
+
+    /// @return Approximate number of queued work items
+    virtual size_t sizeApprox() = 0;
+
+    /**
+     * Enables or disables tracking of work item start times. Disabled by default to avoid clock reads per item.
+     */
+    void setWatched(bool value) {
+        mWatched.store(value, std::memory_order_relaxed);
+        if (!value)
+            mWorkStart.store(0, std::memory_order_relaxed);
+    }
+    /// @return True if work item start times are tracked
+    bool watched() const {
+        return mWatched.load(std::memory_order_relaxed);
+    }
+
+    /// @return Timer::steadyNowCoarse() timestamp at which the current work item started, 0 if idle or not watched
+    int64_t workStartMillis() const {
+        return mWorkStart.load(std::memory_order_relaxed);
+    }
+
+    /// @return Number of work items processed
+    uint64_t workCount() const {
+        return mWorkCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return CPU time consumed by the worker thread in nanoseconds,
+     * or -1 if the thread is not running or the platform does not support per-thread CPU clocks
+     */
+    int64_t cpuTimeNanos() const {
+#ifndef WIN32
+        if (mCpuClockValid.load(std::memory_order_acquire)) {
+            timespec ts {};
+            if (clock_gettime(mCpuClock, &ts) == 0)
+                return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        }
+#endif
+        return -1;
+    }
+
+protected:
+    /// Called on the worker thread when it starts
+    void beginThread() {
+#ifndef WIN32
+        if (pthread_getcpuclockid(pthread_self(), &mCpuClock) == 0)
+            mCpuClockValid.store(true, std::memory_order_release);
+#endif
+    }
+    /// Called on the worker thread before it exits
+    void endThread() {
+        mCpuClockValid.store(false, std::memory_order_release);
+    }
+
+    /// Called on the worker thread before each work item
+    void beginWork() {
+        if (mWatched.load(std::memory_order_relaxed))
+            mWorkStart.store(Timer::steadyNowCoarse(), std::memory_order_relaxed);
+    }
+    /// Called on the worker thread after each work item
+    void endWork() {
+        if (mWatched.load(std::memory_order_relaxed))
+            mWorkStart.store(0, std::memory_order_relaxed);
+        mWorkCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::string mName;
+    std::atomic_bool mWatched = ATOMIC_VAR_INIT(false);
+    std::atomic<int64_t> mWorkStart = ATOMIC_VAR_INIT(0);
+    std::atomic<uint64_t> mWorkCount = ATOMIC_VAR_INIT(0);
+
+#ifndef WIN32
+    clockid_t mCpuClock {};
+#endif
+    std::atomic_bool mCpuClockValid = ATOMIC_VAR_INIT(false);
+};
+
+#endif //COMMONS_WORKERSTATUS_H
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_WORKERWATCHDOG_H
+#define COMMONS_WORKERWATCHDOG_H
+
+#include <commons/thread/WorkerStatus.h>
+#include <commons/log/Log.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/**
+ * Periodically checks watched workers for work items running longer than a threshold.
+ *
+ * Each stalled work item is reported once, together with the worker's queue depth and the share of CPU time the
+ * worker thread consumed since the previous check. A high share means the worker is busy computing, a share near zero
+ * means it is blocked, e.g. on I/O without timeout.
+ */
+class WorkerWatchdog {
+public:
+    struct Report {
+        // worker name
+        std::string name;
+        // milliseconds the current work item is running
+        int64_t busyMillis;
+        // approximate number of queued work items
+        size_t queueDepth;
+        // total CPU time of the worker thread in nanoseconds, -1 if unavailable
+        int64_t cpuTimeNanos;
+        // CPU time per wall time since the previous check in [0, 1], -1 if unavailable
+        double cpuUsage;
+    };
+    using ReportCallback_t = std::function<void(const Report &)>;
+
+    /**
+     * Creates a watchdog, does not start checking yet
+     *
+     * @param thresholdMillis Work items running at least this long are reported
+     * @param intervalMillis Interval between checks of the watchdog thread
+     * @param callback Called on the checking thread for every stalled work item, defaults to logging a warning.
+     * Must not call watch or unwatch.
+     */
+    explicit WorkerWatchdog(int64_t thresholdMillis, int64_t intervalMillis = 1000,
+                            ReportCallback_t callback = &WorkerWatchdog::logReport)
+            : mThresholdMillis(thresholdMillis), mIntervalMillis(intervalMillis), mCallback(std::move(callback)) { }
+
+    ~WorkerWatchdog() {
+        stop();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        for (auto &entry : mEntries)
+            entry.worker->setWatched(false);
+    }
+
+    /**
+     * Starts watching a worker. Enables work start tracking on the worker.
+     *
+     * @param worker Worker to watch, must stay valid until unwatched or the watchdog is destroyed
+     */
+    void watch(WorkerStatus *worker) {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        worker->setWatched(true);
+        mEntries.push_back({worker, Timer::steadyNowCoarse(), worker->cpuTimeNanos(), 0});
+    }
+
+    /**
+     * Stops watching a worker. Disables work start tracking on the worker.
+     */
+    void unwatch(WorkerStatus *worker) {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        worker->setWatched(false);
+        mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(), [worker] (const Entry &entry) {
+            return entry.worker == worker;
+        }), mEntries.end());
+    }
+
+    /// Starts the checking thread
+    void start() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mThread.joinable())
+            return;
+
+        mStopped = false;
+        mThread = std::thread(&WorkerWatchdog::threadEntry, this);
+    }
+
+    /// Stops the checking thread
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStopped = true;
+            mCond.notify_all();
+        }
+
+        if (mThread.joinable())
+            mThread.join();
+    }
+
+    /**
+     * Checks all watched workers once and reports new stalls. Called by the checking thread, can be called manually.
+     */
+    void check() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        // same clock as WorkerStatus::workStartMillis()
+        int64_t now = Timer::steadyNowCoarse();
+
+        for (auto &entry : mEntries) {
+            int64_t cpuTime = entry.worker->cpuTimeNanos();
+            int64_t workStart = entry.worker->workStartMillis();
+
+            // cpu share since previous sample
+            double cpuUsage = -1;
+            if (cpuTime >= 0 && entry.lastCpuTimeNanos >= 0 && now > entry.lastSampleMillis)
+                cpuUsage = std::min(1.0, static_cast<double>(cpuTime - entry.lastCpuTimeNanos)
+                                         / (static_cast<double>(now - entry.lastSampleMillis) * 1e6));
+            entry.lastSampleMillis = now;
+            entry.lastCpuTimeNanos = cpuTime;
+
+            // report every stalled work item once, identified by its start time
+            if (workStart > 0 && now - workStart >= mThresholdMillis && workStart != entry.reportedStart) {
+                entry.reportedStart = workStart;
+
+                if (mCallback)
+                    mCallback({entry.worker->name(), now - workStart, entry.worker->sizeApprox(), cpuTime, cpuUsage});
+            }
+        }
+    }
+
+    /// Default report callback, logs a warning
+    static void logReport(const Report &report) {
+        std::stringstream bruce;
+        bruce << "Worker \"" << report.name << "\" stalled in doWork for " << report.busyMillis
+              << "ms, queue depth " << report.queueDepth;
+
+        if (report.cpuUsage >= 0)
+            bruce << ", cpu " << static_cast<int>(report.cpuUsage * 100) << "% ("
+                  << (report.cpuUsage >= 0.5 ? "busy" : "blocked") << "), total cpu "
+                  << report.cpuTimeNanos / 1000000 << "ms";
+
+        L_warn << bruce.str();
+    }
+
+protected:
+    struct Entry {
+        WorkerStatus *worker;
+        int64_t lastSampleMillis;
+        int64_t lastCpuTimeNanos;
+        int64_t reportedStart;
+    };
+
+    void threadEntry() {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        while (!mStopped) {
+            mCond.wait_for(lock, std::chrono::milliseconds(mIntervalMillis));
+            if (mStopped)
+                break;
+
+            lock.unlock();
+            check();
+            lock.lock();
+        }
+    }
+
+    int64_t mThresholdMillis;
+    int64_t mIntervalMillis;
+    ReportCallback_t mCallback;
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::thread mThread;
+    bool mStopped = false;
+
+    std::vector<Entry> mEntries;
+};
+
+#endif //COMMONS_WORKERWATCHDOG_H
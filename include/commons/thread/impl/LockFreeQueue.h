@@ -40,7 +40,7 @@ public:
     }
     void push(T &&value) override {
         // this will wake up pop_wait
-        mQueue.enqueue(value);
+        mQueue.enqueue(std::move(value));
     }
 
     bool pop(T &value) override {
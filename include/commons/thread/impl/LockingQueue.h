@@ -46,7 +46,7 @@ public:
         std::unique_lock<std::mutex> lock(mMutex);
 
         // add value, signal
-        mQueue.push(value);
+        mQueue.push(std::move(value));
         mCond.notify_one();
     }
 
@@ -54,7 +54,7 @@ public:
         std::unique_lock<std::mutex> lock(mMutex);
 
         if (!mQueue.empty()) {
-            value = mQueue.front();
+            value = std::move(mQueue.front());
             mQueue.pop();
             return true;
         }
@@ -71,7 +71,7 @@ public:
             mCond.wait(lock);
 
         if (!aborted) {
-            value = mQueue.front();
+            value = std::move(mQueue.front());
             mQueue.pop();
             return true;
         }
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_BYTESEARCH_H
+#define COMMONS_BYTESEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Set of byte values, prepared for vectorized search. Construction is constexpr, so sets used on hot paths should be
+ * static constexpr.
+ */
+class ByteSet {
+public:
+    /// empty set
+    constexpr ByteSet() = default;
+
+    /// set containing every byte of bytes
+    constexpr explicit ByteSet(std::string_view bytes) {
+        for (char c : bytes)
+            addByte(static_cast<uint8_t>(c));
+        prepare();
+    }
+
+    /// set containing every byte in [first, last]
+    static constexpr ByteSet range(char first, char last) {
+        ByteSet result;
+        for (unsigned c = static_cast<uint8_t>(first); c <= static_cast<uint8_t>(last); c++)
+            result.addByte(static_cast<uint8_t>(c));
+        result.prepare();
+        return result;
+    }
+
+    /// @return Union of both sets
+    constexpr ByteSet operator|(const ByteSet &other) const {
+        ByteSet result;
+        for (int i = 0; i < 4; i++)
+            result.mBits[i] = mBits[i] | other.mBits[i];
+        result.prepare();
+        return result;
+    }
+
+    /// @return Set of all bytes not in this set
+    constexpr ByteSet operator~() const {
+        ByteSet result;
+        for (int i = 0; i < 4; i++)
+            result.mBits[i] = ~mBits[i];
+        result.prepare();
+        return result;
+    }
+
+    /// @return True if the set contains b
+    constexpr bool contains(uint8_t b) const {
+        return (mBits[b >> 6] >> (b & 63)) & 1;
+    }
+
+protected:
+    friend class ByteSearch;
+    friend struct ByteSearchKernels;
+
+    // SSE2 kernels test sets of up to MAX_RANGES contiguous ranges, larger sets need AVX2 or the scalar loop
+    static constexpr int MAX_RANGES = 8;
+
+    constexpr void addByte(uint8_t b) {
+        mBits[b >> 6] |= uint64_t(1) << (b & 63);
+    }
+
+    constexpr void prepare() {
+        mRangeCount = 0;
+        for (unsigned b = 0; b < 256; b++) {
+            // nibble tables for the AVX2 lookup: row of the low nibble, one bit per high nibble modulo 8
+            uint8_t low = b & 0x0F, high = b >> 4;
+            uint8_t bit = uint8_t(1) << (high & 7);
+            if (contains(static_cast<uint8_t>(b))) {
+                if (high < 8)
+                    mNibbleLow[low] |= bit;
+                else
+                    mNibbleHigh[low] |= bit;
+            }
+
+            // contiguous ranges for the SSE2 comparison
+            if (!contains(static_cast<uint8_t>(b)) || (b > 0 && contains(static_cast<uint8_t>(b - 1))))
+                continue;
+
+            unsigned last = b;
+            while (last < 255 && contains(static_cast<uint8_t>(last + 1)))
+                last++;
+
+            if (mRangeCount < MAX_RANGES) {
+                mRangeFirst[mRangeCount] = static_cast<uint8_t>(b);
+                mRangeLength[mRangeCount] = static_cast<uint8_t>(last - b);
+            }
+            mRangeCount++;
+        }
+    }
+
+    uint64_t mBits[4] {};
+    uint8_t mNibbleLow[16] {};
+    uint8_t mNibbleHigh[16] {};
+    uint8_t mRangeFirst[MAX_RANGES] {};
+    // range length minus one
+    uint8_t mRangeLength[MAX_RANGES] {};
+    int mRangeCount = 0;
+};
+
+/**
+ * Vectorized byte search primitives.
+ *
+ * Kernels use SSE2 or AVX2 on x86, selected once at runtime from the CPU features, and a scalar loop otherwise.
+ * Short inputs are searched by the scalar loop directly.
+ */
+class ByteSearch {
+public:
+    static constexpr size_t npos = std::string_view::npos;
+
+    /**
+     * @param str String to search
+     * @param set Bytes to search for
+     * @param pos Position to start at
+     * @return Position of the first byte of str at or after pos contained in set, npos if none
+     */
+    static size_t findFirstOf(std::string_view str, const ByteSet &set, size_t pos = 0) {
+        return search(str, set, pos, false);
+    }
+
+    /**
+     * @param str String to search
+     * @param set Bytes to skip
+     * @param pos Position to start at
+     * @return Position of the first byte of str at or after pos not contained in set, npos if none
+     */
+    static size_t findFirstNotOf(std::string_view str, const ByteSet &set, size_t pos = 0) {
+        return search(str, set, pos, true);
+    }
+
+    /**
+     * @return Number of bytes of str contained in set
+     */
+    static size_t count(std::string_view str, const ByteSet &set);
+
+    /**
+     * Finds a substring, like std::string_view::find. Multi-byte needles are located by comparing their first and
+     * last byte against a whole vector of candidate positions at once.
+     *
+     * @param str String to search
+     * @param needle Substring to find
+     * @param pos Position to start at
+     * @return Position of the first occurrence of needle at or after pos, npos if none
+     */
+    static size_t find(std::string_view str, std::string_view needle, size_t pos = 0);
+
+    /**
+     * @return Name of the selected kernels: "avx2", "sse2" or "scalar"
+     */
+    static const char *kernelName();
+
+    /**
+     * Selects kernels by name instead of the CPU features, for tests and benchmarks. Not thread-safe with respect to
+     * concurrent searches.
+     *
+     * @param name "avx2", "sse2" or "scalar"
+     * @return False if the kernels are unknown or not supported by the CPU
+     */
+    static bool selectKernel(std::string_view name);
+
+protected:
+    friend struct ByteSearchKernels;
+
+    // below this size, the scalar loop beats the vector setup
+    static constexpr size_t SCALAR_THRESHOLD = 16;
+
+    static size_t search(std::string_view str, const ByteSet &set, size_t pos, bool negate) {
+        if (pos >= str.size())
+            return npos;
+
+        size_t size = str.size() - pos;
+        const auto *data = reinterpret_cast<const uint8_t *>(str.data()) + pos;
+        size_t found = size < SCALAR_THRESHOLD ? searchScalar(data, size, set, negate)
+                                               : searchVector(data, size, set, negate);
+        return found < size ? pos + found : npos;
+    }
+
+    static size_t searchScalar(const uint8_t *data, size_t size, const ByteSet &set, bool negate) {
+        for (size_t i = 0; i < size; i++)
+            if (set.contains(data[i]) != negate)
+                return i;
+        return size;
+    }
+
+    static size_t searchVector(const uint8_t *data, size_t size, const ByteSet &set, bool negate);
+};
+
+#endif //COMMONS_BYTESEARCH_H
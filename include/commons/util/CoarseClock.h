@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_COARSECLOCK_H
+#define COMMONS_COARSECLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * Millisecond clocks for hot paths that do not need exact timestamps.
+ *
+ * By default, reads use CLOCK_REALTIME_COARSE and CLOCK_MONOTONIC_COARSE where available, which avoid reading the
+ * hardware clock but only advance once per kernel tick (usually 1-4ms). While the opt-in ticker runs, reads are a
+ * single atomic load of values a background thread refreshes every interval.
+ *
+ * Values share their origin with Time::now() and Timer::steadyNow() respectively, but may lag behind them by up to
+ * one tick or interval. All functions are thread-safe.
+ */
+class CoarseClock {
+public:
+    /**
+     * @return Coarse milliseconds since the Unix epoch
+     */
+    static int64_t wallNow() {
+        if (mTicking.load(std::memory_order_relaxed))
+            return mWallMillis.load(std::memory_order_relaxed);
+        return readWall();
+    }
+
+    /**
+     * @return Coarse milliseconds of the monotonic clock
+     */
+    static int64_t steadyNow() {
+        if (mTicking.load(std::memory_order_relaxed))
+            return mSteadyMillis.load(std::memory_order_relaxed);
+        return readSteady();
+    }
+
+    /**
+     * @return Timestamp for log records: the ticker value while the ticker runs, otherwise the exact wall clock.
+     * Log timestamps thus only lose precision when the ticker is started.
+     */
+    static int64_t logNow() {
+        if (mTicking.load(std::memory_order_relaxed))
+            return mWallMillis.load(std::memory_order_relaxed);
+
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Starts the background ticker, or adds a reference to the running ticker. Every call must be paired with stop().
+     *
+     * @param intervalMillis Refresh interval, only used by the call that starts the ticker
+     */
+    static void start(int64_t intervalMillis = 1);
+
+    /**
+     * Removes a reference to the ticker and stops it after the last reference is gone
+     */
+    static void stop();
+
+    /// @return True while the ticker runs
+    static bool ticking() {
+        return mTicking.load(std::memory_order_relaxed);
+    }
+
+protected:
+    static int64_t readWall() {
+#ifdef CLOCK_REALTIME_COARSE
+        timespec ts {};
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#else
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static int64_t readSteady() {
+#ifdef CLOCK_MONOTONIC_COARSE
+        timespec ts {};
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#else
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static void threadEntry(int64_t intervalMillis);
+    static void update();
+
+    static inline std::atomic_bool mTicking = ATOMIC_VAR_INIT(false);
+    static inline std::atomic<int64_t> mWallMillis = ATOMIC_VAR_INIT(0);
+    static inline std::atomic<int64_t> mSteadyMillis = ATOMIC_VAR_INIT(0);
+};
+
+#endif //COMMONS_COARSECLOCK_H
@@ -48,7 +48,7 @@ DEFINE_ERROR_FQ(base, runtime_error, std::runtime_error);
         _message << message << " in " __FILE__ ":" VD_LINE;  \
                                                              \
         if (Except::reporting()) {                           \
-            Log::loglevel << _message.str();                 \
+            L_##loglevel << _message.str();                  \
         }                                                    \
                                                              \
         rt;                                                  \
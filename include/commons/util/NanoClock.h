@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_NANOCLOCK_H
+#define COMMONS_NANOCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+// TSC is read with rdtsc on x86 compilers supporting 128 bit integers for the conversion
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SIZEOF_INT128__)
+    #define COMMONS_NANOCLOCK_TSC 1
+    #include <x86intrin.h>
+#else
+    #define COMMONS_NANOCLOCK_TSC 0
+#endif
+
+/**
+ * Monotonic clock with nanosecond resolution for measuring short durations on hot paths.
+ *
+ * Uses the time stamp counter if the CPU has an invariant TSC, which costs a few nanoseconds per read. Its frequency is
+ * calibrated once against CLOCK_MONOTONIC on first use, which takes about 10ms. Otherwise, clock_gettime with
+ * CLOCK_MONOTONIC (std::chrono::steady_clock on Windows) is used.
+ *
+ * Values share their origin with CLOCK_MONOTONIC, but may drift from it by a few microseconds per second.
+ * All functions are thread-safe.
+ */
+class NanoClock {
+public:
+    /**
+     * @return Nanoseconds of the monotonic clock
+     */
+    static int64_t now() {
+#if COMMONS_NANOCLOCK_TSC
+        const Calibration &calibration = NanoClock::calibration();
+        if (calibration.useTsc) {
+            auto ticks = static_cast<int64_t>(__rdtsc() - calibration.baseTicks);
+            auto nanos = static_cast<int64_t>((static_cast<__int128>(ticks) * calibration.mult) >> SHIFT);
+            return calibration.baseNanos + nanos;
+        }
+#endif
+        return monotonicNow();
+    }
+
+    /**
+     * @return Nanoseconds of the monotonic system clock, without TSC
+     */
+    static int64_t monotonicNow() {
+#ifndef WIN32
+        timespec ts {};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * @return True if now() reads the TSC
+     */
+    static bool usesTsc() {
+        return calibration().useTsc;
+    }
+
+    /**
+     * @return Calibrated TSC frequency in Hz, 0 if the TSC is not used
+     */
+    static double tscFrequency() {
+        return calibration().frequency;
+    }
+
+protected:
+    static constexpr int SHIFT = 32;
+
+    struct Calibration {
+        bool useTsc = false;
+        double frequency = 0;
+        uint64_t baseTicks = 0;
+        int64_t baseNanos = 0;
+        // nanoseconds per tick, fixed point with SHIFT fraction bits
+        int64_t mult = 0;
+    };
+
+    static const Calibration &calibration() {
+        static const Calibration instance = calibrate();
+        return instance;
+    }
+
+    static Calibration calibrate();
+};
+
+#endif //COMMONS_NANOCLOCK_H
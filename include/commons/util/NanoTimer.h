@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_NANOTIMER_H
+#define COMMONS_NANOTIMER_H
+
+#include <commons/util/NanoClock.h>
+#include <commons/util/Timer.h>
+
+/**
+ * Same as Timer, but with nanosecond precision based on NanoClock.
+ */
+class NanoTimer {
+public:
+    using begin = Timer::begin;
+
+    /// create empty timer
+    NanoTimer() = default;
+
+    /// create timer with specified duration, do not start timer yet
+    explicit NanoTimer(int64_t durationNanos) : mDurationNanos(durationNanos) { }
+    /// create timer with specified start type and duration, start timer if requested
+    explicit NanoTimer(begin st, int64_t durationNanos = 0) : NanoTimer(durationNanos) {
+        if (st == begin::now)
+            start();
+    }
+
+    /// start timer with previously specified duration, move to "active" state
+    void start() {
+        mStartTime = steadyNow();
+        mActive = true;
+    }
+
+    /// start timer with specified number of nanoseconds, move to "active" state
+    void start(int64_t durationNanos) {
+        mDurationNanos = durationNanos;
+        start();
+    }
+
+    /// reset timer to "not running" state
+    void reset() {
+        mActive = false;
+        mStartTime = 0;
+        mDurationNanos = 0;
+    }
+
+    /// @returns True if timer is in "active" state
+    bool active() const {
+        return mActive;
+    }
+
+    /// @returns True if timer is in "active" state and not elapsed
+    bool running() const {
+        return active() && runningNanos() < mDurationNanos;
+    }
+
+    /// @returns True if timer is in "active" state and elapsed
+    bool elapsed() const {
+        return active() && runningNanos() >= mDurationNanos;
+    }
+
+    /// @returns Number of nanoseconds since start of timer if "active", otherwise 0.
+    int64_t runningNanos() const {
+        return active() ? steadyNow() - mStartTime : 0;
+    }
+
+    /// @returns Number of milliseconds since start of timer if "active", otherwise 0.
+    int64_t runningMillis() const {
+        return runningNanos() / 1000000;
+    }
+
+    /// @returns Number of nanoseconds set as duration during the start of timer.
+    int64_t durationNanos() const {
+        return mDurationNanos;
+    }
+
+    /// @returns Number of nanoseconds left until timer elapses, or 0 if elapsed/not "active"
+    int64_t leftNanos() const {
+        auto elapsed = runningNanos();
+        if (active() && elapsed <= mDurationNanos)
+            return mDurationNanos - elapsed;
+
+        return 0;
+    }
+
+    /// @returns Nanoseconds of the clock used by all nano timers
+    static inline int64_t steadyNow() {
+        return NanoClock::now();
+    }
+
+protected:
+    // unlike Timer, a start time of 0 is valid
+    bool mActive = false;
+    int64_t mStartTime = 0;
+    int64_t mDurationNanos = 0;
+};
+
+#endif //COMMONS_NANOTIMER_H
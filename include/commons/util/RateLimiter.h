@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_RATELIMITER_H
+#define COMMONS_RATELIMITER_H
+
+#include <commons/util/Timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <thread>
+
+/**
+ * Lock-free token bucket rate limiter.
+ *
+ * The bucket state is a single atomic word holding the theoretical arrival time of the next token (GCRA), measured
+ * in nanoseconds on the monotonic clock of Timer. Tokens refill continuously at the configured rate, up to burst tokens can be taken at once.
+ */
+class alignas(64) RateLimiter {
+public:
+    /**
+     * Creates a full bucket
+     *
+     * @param ratePerSecond Number of tokens added per second, must be positive
+     * @param burst Bucket capacity, the maximum number of tokens that can be acquired at once
+     */
+    explicit RateLimiter(double ratePerSecond, uint32_t burst = 1)
+            : mIntervalNanos(static_cast<int64_t>(1e9 / ratePerSecond)),
+              mToleranceNanos(mIntervalNanos * burst) { }
+
+    /**
+     * Takes n tokens if available, never blocks
+     *
+     * @param n Number of tokens
+     * @return True if the tokens were taken
+     */
+    bool tryAcquire(uint32_t n = 1) {
+        return reserve(n, 0);
+    }
+
+    /**
+     * Takes n tokens, waiting until they become available or the timeout would be exceeded.
+     * Fails immediately if the tokens cannot become available within the timeout.
+     *
+     * @param n Number of tokens, must not exceed burst
+     * @param timeoutMillis Maximum time to wait in milliseconds
+     * @return True if the tokens were taken
+     */
+    bool acquire(uint32_t n, int64_t timeoutMillis) {
+        return reserve(n, timeoutMillis * 1000000);
+    }
+
+    /// Refills the bucket
+    void reset() {
+        mTat.store(0, std::memory_order_relaxed);
+    }
+
+protected:
+    static int64_t nowNanos() {
+        // full resolution, a millisecond clock would cap the rate at burst tokens per millisecond
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool reserve(uint32_t n, int64_t maxWaitNanos) {
+        int64_t cost = mIntervalNanos * n;
+        if (cost > mToleranceNanos)
+            return false;
+
+        int64_t now = nowNanos();
+        int64_t tat = mTat.load(std::memory_order_relaxed);
+        int64_t wait;
+        do {
+            // an empty bucket has its arrival time in the past
+            int64_t newTat = std::max(tat, now) + cost;
+
+            wait = newTat - mToleranceNanos - now;
+            if (wait > maxWaitNanos)
+                return false;
+
+            if (mTat.compare_exchange_weak(tat, newTat, std::memory_order_relaxed))
+                break;
+        } while (true);
+
+        // tokens are reserved, wait until they are due
+        if (wait > 0)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+        return true;
+    }
+
+    int64_t mIntervalNanos;
+    int64_t mToleranceNanos;
+    std::atomic<int64_t> mTat = ATOMIC_VAR_INIT(0);
+};
+
+/**
+ * Rate limiter with independent buckets per key.
+ *
+ * Keys are hashed into a fixed number of buckets, so checks neither lock nor allocate. Keys that share a bucket share
+ * its tokens, so the bucket count should be well above the number of concurrently active keys.
+ *
+ * @tparam K Key type
+ */
+template<typename K, typename Hash = std::hash<K>>
+class ShardedRateLimiter {
+public:
+    /**
+     * Creates full buckets
+     *
+     * @param ratePerSecond Number of tokens added per second to each bucket
+     * @param burst Capacity of each bucket
+     * @param bucketCount Number of buckets, rounded up to the next power of two
+     */
+    ShardedRateLimiter(double ratePerSecond, uint32_t burst = 1, size_t bucketCount = 64) {
+        size_t count = 1;
+        while (count < bucketCount)
+            count *= 2;
+
+        mBucketMask = count - 1;
+        for (size_t i = 0; i < count; i++)
+            mBuckets.emplace_back(ratePerSecond, burst);
+    }
+
+    /// @see RateLimiter::tryAcquire
+    bool tryAcquire(const K &key, uint32_t n = 1) {
+        return bucket(key).tryAcquire(n);
+    }
+
+    /// @see RateLimiter::acquire
+    bool acquire(const K &key, uint32_t n, int64_t timeoutMillis) {
+        return bucket(key).acquire(n, timeoutMillis);
+    }
+
+    /// Refills all buckets
+    void reset() {
+        for (auto &bucket : mBuckets)
+            bucket.reset();
+    }
+
+protected:
+    RateLimiter &bucket(const K &key) {
+        uint64_t h = static_cast<uint64_t>(Hash()(key)) * 0x9e3779b97f4a7c15ull;
+        return mBuckets[(h >> 32) & mBucketMask];
+    }
+
+    size_t mBucketMask;
+    // deque keeps the non-movable limiters in place
+    std::deque<RateLimiter> mBuckets;
+};
+
+#endif //COMMONS_RATELIMITER_H
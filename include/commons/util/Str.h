@@ -19,16 +19,132 @@
 #ifndef COMMONS_STR_H
 #define COMMONS_STR_H
 
+#include <commons/util/ByteSearch.h>
+
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <cstdlib>
+#include <iterator>
 
 /**
  * Utility for common string operations
  */
 class Str {
 public:
+    /**
+     * Forward range over the parts of a string, see Str::tokenize
+     */
+    class Tokenizer {
+    protected:
+        struct Params {
+            std::string_view str;
+            std::string_view delim;
+            size_t maxParts;
+            bool allowEmpty;
+        };
+
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view *;
+            using reference = const std::string_view &;
+
+            /// end iterator
+            iterator() = default;
+
+            reference operator*() const {
+                return mPart;
+            }
+            pointer operator->() const {
+                return &mPart;
+            }
+
+            iterator &operator++() {
+                next();
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator copy = *this;
+                next();
+                return copy;
+            }
+
+            bool operator==(const iterator &other) const {
+                // iterators over the same string are equal at the same position, all end iterators are equal
+                if (mEnd || other.mEnd)
+                    return mEnd == other.mEnd;
+                return mParams.str.data() == other.mParams.str.data() && mNext == other.mNext;
+            }
+            bool operator!=(const iterator &other) const {
+                return !(*this == other);
+            }
+
+        protected:
+            friend class Tokenizer;
+
+            explicit iterator(const Params &params) : mParams(params), mEnd(false) {
+                next();
+            }
+
+            void next() {
+                while (mNext != std::string_view::npos) {
+                    // split at next delimiter unless adding it + left-overs would exceed max parts
+                    size_t found = std::string_view::npos;
+                    if (mParams.maxParts == 0 || mCount + 1 < mParams.maxParts)
+                        found = ByteSearch::find(mParams.str, mParams.delim, mNext);
+
+                    if (found != std::string_view::npos) {
+                        mPart = mParams.str.substr(mNext, found - mNext);
+                        mNext = found + mParams.delim.size();
+                        mCount++;
+                    }
+                    else {
+                        // left-over portion
+                        mPart = mParams.str.substr(mNext);
+                        mNext = std::string_view::npos;
+                    }
+
+                    if (mParams.allowEmpty || !mPart.empty())
+                        return;
+                }
+
+                // exhausted, become end iterator
+                mEnd = true;
+                mPart = {};
+            }
+
+            // copy of the parameters, so iterators do not depend on the range object
+            Params mParams {};
+            bool mEnd = true;
+            std::string_view mPart;
+            // start of the remaining string, npos after the left-over portion
+            size_t mNext = 0;
+            size_t mCount = 0;
+        };
+
+        Tokenizer(std::string_view str, std::string_view delim, size_t maxParts, bool allowEmpty)
+                : mParams({str, delim, maxParts, allowEmpty}) { }
+
+        iterator begin() const {
+            // protect against empty delimiter
+            if (mParams.delim.empty())
+                return end();
+            return iterator(mParams);
+        }
+
+        iterator end() const {
+            return {};
+        }
+
+    protected:
+        Params mParams;
+    };
+
     /**
      * Split string at delimiter into parts
      *
@@ -41,28 +157,26 @@ public:
     static inline std::vector<std::string> splitAll(const std::string &str, const std::string &delim,
                                                     size_t maxParts = 0, bool allowEmpty = true) {
         std::vector<std::string> result;
-        size_t next, last = 0, count = 0;
-
-        // protect against empty delimiter
-        if (delim.empty())
-            return {};
-
-        // only enter loop if a next delimiter was found, and adding it + left-overs would not exceed max parts
-        while ((next = str.find(delim, last)) != std::string::npos && (maxParts == 0 || count + 1 < maxParts)) {
-            if (allowEmpty || last < next)
-                result.emplace_back(str.substr(last, next - last));
-
-            last = next + delim.size();
-            count++;
-        }
-
-        // add left-over portion
-        if (allowEmpty || last < str.size())
-            result.emplace_back(str.substr(last));
+        for (auto part : tokenize(str, delim, maxParts, allowEmpty))
+            result.emplace_back(part);
 
         return result;
     }
 
+    /**
+     * Lazily splits a string at delimiter into parts, without copying. Same semantics as splitAll.
+     *
+     * @param str String to split into parts, must outlive the returned range, its iterators and the parts
+     * @param delim Delimiter to split at, must not be empty. Must outlive the returned range and its iterators.
+     * @param maxParts Maximum number of parts. The last part may contain delim if maxParts has been reached
+     * @param allowEmpty If false, empty parts are skipped
+     * @return Range of string_view parts without delim
+     */
+    static inline Tokenizer tokenize(std::string_view str, std::string_view delim, size_t maxParts = 0,
+                                     bool allowEmpty = true) {
+        return {str, delim, maxParts, allowEmpty};
+    }
+
     /**
      * Join all parts into one string with delimiter
      *
@@ -71,12 +185,32 @@ public:
      * @return Joined string
      */
     static inline std::string joinAll(const std::vector<std::string> &parts, const std::string &delim) {
-        std::stringstream bruce;
+        return joinAll(parts.begin(), parts.end(), delim);
+    }
+
+    /**
+     * Join all parts in [begin, end) into one string with delimiter. The result is allocated once.
+     *
+     * @param begin Forward iterator to the first part, parts must be convertible to std::string_view
+     * @param end Iterator past the last part
+     * @param delim Delimiter to insert in between parts when joining
+     * @return Joined string
+     */
+    template<typename It>
+    static inline std::string joinAll(It begin, It end, std::string_view delim) {
+        size_t size = 0, count = 0;
+        for (auto it = begin; it != end; ++it, count++)
+            size += std::string_view(*it).size();
 
-        for (size_t i = 0; i < parts.size(); i++)
-            bruce << (i ? delim : "") << parts[i];
+        std::string result;
+        result.reserve(size + (count ? (count - 1) * delim.size() : 0));
+        for (auto it = begin; it != end; ++it) {
+            if (it != begin)
+                result.append(delim);
+            result.append(std::string_view(*it));
+        }
 
-        return bruce.str();
+        return result;
     }
 };
 
@@ -21,6 +21,7 @@
 #define COMMONS_TIME_H
 
 #include <commons/util/Except.h>
+#include <commons/util/CoarseClock.h>
 
 #include <chrono>
 #include <iomanip>
@@ -53,6 +54,15 @@ public:
         return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
     }
 
+    /**
+     * Like now(), but cheaper and lagging behind by up to a few milliseconds.
+     *
+     * @see CoarseClock::wallNow
+     */
+    static inline int64_t nowCoarse() {
+        return CoarseClock::wallNow();
+    }
+
     static Time nowUTC() {
         return Time(now(), true);
     }
@@ -126,19 +136,13 @@ public:
     }
 
     /**
-     * Formats the UTC timestamp in ISO 8601 format.
+     * Formats the UTC timestamp in ISO 8601 format. Uses TimeFormat, see there for formatting into a buffer.
      *
      * Note:
      * Format is <date>T<time>Z with <date> YYYY-MM-DD and <time> HH:MM:SS.SSS
      * This function is thread-safe.
      */
-    std::string formatIso8601() {
-        /*
-         * Note: On windows/wine using mingw-w64, std::put_time does not handle the C++11 cases of %T and %F,
-         * despite the C++ standard and documentation stating otherwise. Replace them by their long versions instead.
-         */
-        return formatFull("%Y-%m-%dT%H:%M:%S.%kZ");
-    }
+    std::string formatIso8601();
 
 protected:
     static void gmtime_safe(const time_t *time, tm *result) {
@@ -241,6 +245,7 @@ protected:
 
     void set(int64_t timestamp, bool utc) {
         using namespace std::chrono;
+        mTimestamp = timestamp;
 
         // save millis
         mMillis = static_cast<int>(timestamp % 1000);
@@ -257,12 +262,16 @@ protected:
             localtime_safe(&s_time, &mTime);
     }
 
+    // milliseconds since epoch
+    int64_t mTimestamp = 0;
     // date and time with seconds precision
     tm mTime {};
     // additional millis
     int mMillis = 0;
     // local or UTC time?
     bool mIsUTC = true;
+
+    friend class TimeFormat;
 };
 
 #endif //COMMONS_TIME_H
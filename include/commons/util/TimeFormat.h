@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_TIMEFORMAT_H
+#define COMMONS_TIMEFORMAT_H
+
+#include <commons/util/Time.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Fast timestamp formatter for a subset of the std::put_time format, preparsed once.
+ *
+ * Supported specifiers: %Y %m %d %H %M %S %F (%Y-%m-%d) %T (%H:%M:%S) %k (milliseconds) %z (+HHMM) and %%.
+ * Formatting writes digits from a table into a caller buffer, without std::stringstream, tm conversion or libc locks.
+ * Local time uses a per-thread cache of the UTC offset, refreshed whenever a timestamp falls into another quarter
+ * hour than the previous one, which is the granularity of all UTC offset changes.
+ *
+ * Formatting is thread-safe.
+ */
+class TimeFormat {
+public:
+    /**
+     * Preparses a format
+     *
+     * @param format Format with the supported specifiers, throws time_error on others
+     * @param utc Whether to format in UTC or local time
+     */
+    explicit TimeFormat(std::string_view format, bool utc = true);
+
+    /**
+     * @return Shared UTC format "%Y-%m-%dT%H:%M:%S.%kZ", the format of Time::formatIso8601
+     */
+    static const TimeFormat &iso8601() {
+        static const TimeFormat format("%Y-%m-%dT%H:%M:%S.%kZ");
+        return format;
+    }
+
+    /**
+     * @return Buffer size sufficient for any timestamp
+     */
+    size_t maxSize() const {
+        return mMaxSize;
+    }
+
+    /**
+     * Formats a timestamp into a buffer, without terminating null character
+     *
+     * @param timestamp Milliseconds since epoch
+     * @param buffer Buffer of at least maxSize() bytes
+     * @return Number of bytes written
+     */
+    size_t format(int64_t timestamp, char *buffer) const;
+
+    /**
+     * @param timestamp Milliseconds since epoch
+     * @return Formatted timestamp
+     */
+    std::string format(int64_t timestamp) const {
+        std::string result(mMaxSize, '\0');
+        result.resize(format(timestamp, result.data()));
+        return result;
+    }
+
+    /**
+     * Parses an ISO 8601 timestamp "YYYY-MM-DDTHH:MM:SS" with optional fraction of a second and a zone designator
+     * "Z", "+HH:MM", "+HHMM" or "+HH". Timestamps without zone designator are UTC. Fractions are truncated to
+     * milliseconds.
+     *
+     * @param text Timestamp
+     * @param timestamp Parsed milliseconds since epoch, unchanged if parsing fails
+     * @return True if text is a valid timestamp
+     */
+    static bool tryParseIso8601(std::string_view text, int64_t &timestamp);
+
+    /**
+     * Same as tryParseIso8601, but throws time_error if text is no valid timestamp
+     */
+    static int64_t parseIso8601(std::string_view text) {
+        int64_t timestamp;
+        if (!tryParseIso8601(text, timestamp))
+            throw time_error("Invalid ISO 8601 timestamp: " + std::string(text));
+        return timestamp;
+    }
+
+    /**
+     * @param timestamp Milliseconds since epoch
+     * @return Offset of local time to UTC in seconds at timestamp, cached per thread
+     */
+    static int32_t utcOffsetSeconds(int64_t timestamp);
+
+    /**
+     * @return Days since 1970-01-01 of a date in the proleptic Gregorian calendar
+     */
+    static int64_t daysFromCivil(int64_t year, unsigned month, unsigned day);
+
+    /**
+     * Converts days since 1970-01-01 to a date in the proleptic Gregorian calendar
+     */
+    static void civilFromDays(int64_t days, int64_t &year, unsigned &month, unsigned &day);
+
+protected:
+    enum class Field : uint8_t {
+        Literal,
+        Year,
+        Month,
+        Day,
+        Hour,
+        Minute,
+        Second,
+        Millis,
+        Offset,
+    };
+
+    struct Part {
+        Field field;
+        // literal text in mLiterals
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    void addField(Field field);
+    void addLiteral(std::string_view text);
+
+    std::vector<Part> mParts;
+    std::string mLiterals;
+    size_t mMaxSize = 0;
+    bool mUTC;
+};
+
+#endif //COMMONS_TIMEFORMAT_H
@@ -94,12 +94,22 @@ public:
         return 0;
     }
 
-protected:
+    /// @returns Milliseconds of the monotonic clock used by all timers
     static inline int64_t steadyNow() {
         using namespace std::chrono;
         return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
     }
 
+    /**
+     * Like steadyNow(), but cheaper and lagging behind by up to a few milliseconds.
+     *
+     * @see CoarseClock::steadyNow
+     */
+    static inline int64_t steadyNowCoarse() {
+        return CoarseClock::steadyNow();
+    }
+
+protected:
     int64_t mStartTime = 0;
     int64_t mDurationMillis = 0;
 };
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_TIMERWHEEL_H
+#define COMMONS_TIMERWHEEL_H
+
+#include <commons/util/Timer.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/**
+ * Hierarchical timer wheel for large numbers of timeouts, e.g. connect, IO and heartbeat timeouts of many connections.
+ *
+ * Time advances in ticks of a fixed number of milliseconds. Timeouts are kept in five levels of slots with
+ * intrusive lists, so scheduling and cancelling are O(1) regardless of the number of timeouts. Timeouts expire at the
+ * first tick at or after their due time.
+ *
+ * The wheel is driven by calling advance() regularly from one thread, e.g. an event loop that waits at most
+ * nextTimeoutMillis() (see ConnectionWait::wait). Expiry callbacks run on that thread, without the wheel being locked,
+ * so they may schedule and cancel timeouts. Scheduling and cancelling are thread-safe. A thread blocked until the
+ * previous next timeout learns about new timeouts through the wakeup callback, see setWakeup.
+ */
+class TimerWheel {
+public:
+    using Callback_t = std::function<void()>;
+    using Id = uint64_t;
+    // never returned by schedule
+    static constexpr Id INVALID_ID = 0;
+
+    /**
+     * @param tickMillis Resolution of the wheel in milliseconds
+     * @param nowMillis Current time of the clock passed to advance(), defaults to Timer::steadyNow()
+     */
+    explicit TimerWheel(int64_t tickMillis = 10, int64_t nowMillis = Timer::steadyNow());
+
+    /**
+     * Schedules a callback
+     *
+     * @param delayMillis Milliseconds from nowMillis until the callback is due
+     * @param callback Called once on the thread calling advance()
+     * @param nowMillis Current time, defaults to Timer::steadyNow()
+     * @return Id for cancelling
+     */
+    Id schedule(int64_t delayMillis, Callback_t callback, int64_t nowMillis = Timer::steadyNow());
+
+    /**
+     * Cancels a scheduled callback
+     *
+     * @return True if it was scheduled and has been cancelled, false if it already expired or was cancelled
+     */
+    bool cancel(Id id);
+
+    /**
+     * @return True if the callback is scheduled and did not expire yet
+     */
+    bool pending(Id id) const;
+
+    /**
+     * @param id Id of the callback
+     * @param nowMillis Current time, defaults to Timer::steadyNow()
+     * @return Milliseconds until the callback of id is due, or nullopt if it is not pending
+     */
+    std::optional<int64_t> leftMillis(Id id, int64_t nowMillis = Timer::steadyNow()) const;
+
+    /**
+     * Advances the wheel to a time and calls the callbacks of all expired timeouts
+     *
+     * @param nowMillis Current time, defaults to Timer::steadyNow()
+     * @return Number of expired timeouts
+     */
+    size_t advance(int64_t nowMillis = Timer::steadyNow());
+
+    /**
+     * @param nowMillis Current time, defaults to Timer::steadyNow()
+     * @return Milliseconds until the next timeout may be due, for use as wait timeout of an event loop, or nullopt if
+     * no timeout is pending. For timeouts further away than the first level, this is a lower bound.
+     */
+    std::optional<int64_t> nextTimeoutMillis(int64_t nowMillis = Timer::steadyNow()) const;
+
+    /**
+     * @return Number of pending timeouts
+     */
+    size_t size() const;
+
+    /**
+     * Installs a callback called by every schedule(), e.g. to wake up an event loop waiting for a previous
+     * nextTimeoutMillis(). Called with the wheel locked, so it must not call into the wheel. There is only one
+     * wakeup, as only one thread drives the wheel.
+     *
+     * @param wakeup Callback, or empty to remove the installed one
+     * @return False if another wakeup is installed already, which is kept
+     */
+    bool setWakeup(Callback_t wakeup);
+
+    /**
+     * @return Tick length in milliseconds
+     */
+    int64_t tickMillis() const {
+        return mTickMillis;
+    }
+
+protected:
+    static constexpr int LEVELS = 5;
+    static constexpr int FIRST_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        // absolute tick at which the timeout expires
+        int64_t expiry = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        // slot list the node is linked into, or NIL if free
+        uint32_t slot = NIL;
+        // incremented on every reuse, so stale ids do not match
+        uint32_t generation = 1;
+        Callback_t callback;
+    };
+
+    static int levelShift(int level) {
+        return level == 0 ? 0 : FIRST_BITS + (level - 1) * LEVEL_BITS;
+    }
+    static uint32_t levelSlots(int level) {
+        return level == 0 ? 1u << FIRST_BITS : 1u << LEVEL_BITS;
+    }
+
+    // require mMutex
+    Node *find(Id id);
+    const Node *find(Id id) const;
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+
+    int64_t mTickMillis;
+    // time of tick 0
+    int64_t mOriginMillis;
+    // last processed tick
+    int64_t mCurrentTick = 0;
+
+    mutable std::mutex mMutex;
+    std::vector<Node> mNodes;
+    uint32_t mFreeList = NIL;
+    size_t mSize = 0;
+    // head node of each slot, all levels concatenated
+    std::vector<uint32_t> mSlots;
+    std::array<uint32_t, LEVELS> mLevelOffsets {};
+    Callback_t mWakeup;
+};
+
+/**
+ * Timer-like handle of a timeout in a TimerWheel. The callback is scheduled on start and cancelled on reset or
+ * destruction.
+ */
+class WheelTimer {
+public:
+    /**
+     * @param wheel Wheel to schedule in, must outlive the handle
+     * @param callback Called on the thread driving the wheel when the timer elapses
+     */
+    WheelTimer(TimerWheel &wheel, TimerWheel::Callback_t callback)
+            : mWheel(wheel), mCallback(std::move(callback)) { }
+    ~WheelTimer() {
+        reset();
+    }
+
+    WheelTimer(const WheelTimer &) = delete;
+    WheelTimer &operator=(const WheelTimer &) = delete;
+
+    /// start timer with specified number of milliseconds, restarts if already active
+    void start(int64_t durationMillis) {
+        reset();
+        mDurationMillis = durationMillis;
+        mId = mWheel.schedule(durationMillis, mCallback);
+    }
+
+    /// cancel timer, move to "not running" state
+    void reset() {
+        if (mId != TimerWheel::INVALID_ID)
+            mWheel.cancel(mId);
+        mId = TimerWheel::INVALID_ID;
+        mDurationMillis = 0;
+    }
+
+    /// @returns True if timer is started and not elapsed
+    bool running() const {
+        return mId != TimerWheel::INVALID_ID && mWheel.pending(mId);
+    }
+
+    /// @returns True if timer is started and its callback has been called
+    bool elapsed() const {
+        return mId != TimerWheel::INVALID_ID && !mWheel.pending(mId);
+    }
+
+    /// @returns Number of milliseconds set as duration during the start of timer.
+    int64_t durationMillis() const {
+        return mDurationMillis;
+    }
+
+    /// @returns Number of milliseconds left until timer elapses, or 0 if elapsed/not started
+    int64_t leftMillis() const {
+        return mId != TimerWheel::INVALID_ID ? mWheel.leftMillis(mId).value_or(0) : 0;
+    }
+
+protected:
+    TimerWheel &mWheel;
+    TimerWheel::Callback_t mCallback;
+    TimerWheel::Id mId = TimerWheel::INVALID_ID;
+    int64_t mDurationMillis = 0;
+};
+
+#endif //COMMONS_TIMERWHEEL_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_TIMESTAMPCACHE_H
+#define COMMONS_TIMESTAMPCACHE_H
+
+#include <commons/util/Time.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Formats consecutive timestamps with Time::formatFull, but calls it only once per second.
+ * Within the same second, only the millisecond digits of %k are updated in place.
+ * Not thread-safe, use one instance per thread.
+ */
+class TimestampCache {
+public:
+    /**
+     * @param format Format as accepted by Time::formatFull
+     * @param utc Whether to format in UTC or local time
+     */
+    explicit TimestampCache(std::string format, bool utc = false) : mUTC(utc) {
+        // replace %k by a marker, so that the positions of the millisecond digits can be found in the result
+        for (size_t i = 0; i < format.size(); i++) {
+            if (format[i] == '%' && i + 1 < format.size()) {
+                if (format[i + 1] == 'k')
+                    format.replace(i, 2, MARKER);
+                else
+                    i++;
+            }
+        }
+        mFormat = std::move(format);
+    }
+
+    /**
+     * @param timestamp Milliseconds since epoch
+     * @return Formatted timestamp, valid until the next call
+     */
+    std::string_view format(int64_t timestamp) {
+        int64_t second = timestamp / 1000;
+        if (second != mSecond) {
+            rebuild(second * 1000);
+            mSecond = second;
+        }
+
+        int millis = static_cast<int>(timestamp % 1000);
+        for (size_t pos : mMillisPositions) {
+            mText[pos] = static_cast<char>('0' + millis / 100);
+            mText[pos + 1] = static_cast<char>('0' + millis / 10 % 10);
+            mText[pos + 2] = static_cast<char>('0' + millis % 10);
+        }
+        return mText;
+    }
+
+protected:
+    static constexpr const char *MARKER = "\x7f\x7f\x7f";
+
+    void rebuild(int64_t timestamp) {
+        // time zone offset changes are picked up here, they never happen within a second
+        mText = Time(timestamp, mUTC).formatFull(mFormat);
+
+        mMillisPositions.clear();
+        for (size_t pos = 0; (pos = mText.find(MARKER, pos)) != std::string::npos; pos += 3)
+            mMillisPositions.push_back(pos);
+    }
+
+    std::string mFormat;
+    bool mUTC;
+
+    // second of the cached text, no timestamp maps to INT64_MIN
+    int64_t mSecond = INT64_MIN;
+    std::string mText;
+    std::vector<size_t> mMillisPositions;
+};
+
+#endif //COMMONS_TIMESTAMPCACHE_H
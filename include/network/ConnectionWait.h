@@ -21,6 +21,9 @@
 #define COMMONS_CONNECTIONWAIT_H
 
 #include <network/Connection.h>
+#include <commons/util/TimerWheel.h>
+
+#include <atomic>
 
 DEFINE_ERROR(connection_wait, connection_error);
 
@@ -64,6 +67,12 @@ public:
      */
     void notify();
 
+    /**
+     * Wakes up a currently running/future wait like notify, but without calling its notify callback.
+     * Used to make a wait recompute its timeout.
+     */
+    void wakeup();
+
     /**
      * Wait indefinitely until a socket event is raised for one of the registered connections or a notify is set.
      * If a socket event or a notify already exists, wait will return immediately.
@@ -81,12 +90,32 @@ public:
      */
     bool wait(const NotifyCallback &notifyCallback, const ConnectionCallback_t &connectionCallback);
 
+    /**
+     * Like wait, but waits at most until the next timeout of the timer wheel and advances the wheel afterwards.
+     * Expired timer callbacks run on the calling thread after the notify and connection callbacks.
+     * Returning without socket events because a timeout is due counts as success.
+     *
+     * Timeouts scheduled from other threads during the wait wake it up, so it recomputes its timeout. To do so, the
+     * wait installs a wakeup callback in the wheel for its duration, see TimerWheel::setWakeup. A wheel is driven by
+     * one wait at a time, waiting on a wheel another wait is blocked on throws connection_wait_error.
+     *
+     * @param timers Timer wheel driven by this wait, e.g. holding connect, IO and heartbeat timeouts
+     * @see ConnectionWait::wait
+     */
+    bool wait(const NotifyCallback &notifyCallback, const ConnectionCallback_t &connectionCallback,
+              TimerWheel &timers);
+
 protected:
+    bool waitInternal(const NotifyCallback &notifyCallback, const ConnectionCallback_t &connectionCallback,
+                      TimerWheel *timers);
+
     void connectNotify();
     void clearNotify();
 
     // special socket used for thread-safe wake up of wait
     std::unique_ptr<ISocket> mNotify;
+    // set by notify, distinguishes notifies from wakeups
+    std::atomic_bool mNotified = ATOMIC_VAR_INIT(false);
     // registered connections
     ConnectionList_t mConnections;
 };
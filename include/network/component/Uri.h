@@ -22,6 +22,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Uri {
@@ -29,8 +30,42 @@ public:
     using KeyValuePair_t = std::pair<std::string, std::string>;
     using KeyValuePairList_t = std::vector<KeyValuePair_t>;
 
-    static std::string encode(const std::string &str);
-    static std::string decode(const std::string &str);
+    /**
+     * Percent-encodes all characters except unreserved ones (A-Z, a-z, 0-9, "-", "_", ".", "~")
+     *
+     * @param str String to encode
+     * @return Encoded string, allocated once
+     */
+    static std::string encode(std::string_view str);
+    /**
+     * Percent-encodes str into a caller-provided buffer, see encode
+     *
+     * @param str String to encode
+     * @param out Buffer of at least encodedSize(str) characters
+     * @return Number of characters written
+     */
+    static size_t encode(std::string_view str, char *out);
+    /// @return Exact size of the encoded str
+    static size_t encodedSize(std::string_view str);
+
+    /**
+     * Decodes percent-encoded characters. A "%" not followed by two hex digits is kept as is, never throws.
+     *
+     * @param str String to decode
+     * @return Decoded string, allocated once
+     */
+    static std::string decode(std::string_view str);
+    /**
+     * Decodes str into a caller-provided buffer, see decode
+     *
+     * @param str String to decode
+     * @param out Buffer of at least decodedSize(str) characters, which is at most str.size()
+     * @return Number of characters written
+     */
+    static size_t decode(std::string_view str, char *out);
+    /// @return Exact size of the decoded str
+    static size_t decodedSize(std::string_view str);
+
     static std::string pathCombine(const std::string &a, const std::string &b);
 
     explicit Uri(const std::string &uri);
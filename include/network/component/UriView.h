@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COMMONS_URIVIEW_H
+#define COMMONS_URIVIEW_H
+
+#include <commons/util/Str.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * Non-owning view of a URI, split the same way as Uri but without copying.
+ *
+ * Components are views into the original string, which must outlive the UriView. Query and fragment pairs are only
+ * parsed when looked up, and only the requested values are decoded.
+ */
+class UriView {
+public:
+    explicit UriView(std::string_view uri);
+
+    std::string_view schema() const {
+        return mSchema;
+    }
+
+    std::string_view host() const {
+        return mHost;
+    }
+
+    /// @return Raw path without leading "/", may contain repeated "/" unlike Uri::path()
+    std::string_view path() const {
+        return mPath;
+    }
+
+    /// @return Range of non-empty path parts, same as Uri::pathParts()
+    Str::Tokenizer pathParts() const {
+        return Str::tokenize(mPath, "/", 0, false);
+    }
+
+    /// @return Raw, still encoded query
+    std::string_view query() const {
+        return mQuery;
+    }
+
+    /// @return Decoded value of the first query pair with the given decoded key
+    std::optional<std::string> queryValue(std::string_view key) const {
+        return findValue(mQuery, key);
+    }
+    std::string queryValue(std::string_view key, const std::string &fallback) const {
+        return queryValue(key).value_or(fallback);
+    }
+
+    /// @return Raw, still encoded fragment
+    std::string_view fragment() const {
+        return mFragment;
+    }
+
+    /// @return Decoded value of the first fragment pair with the given decoded key
+    std::optional<std::string> fragmentValue(std::string_view key) const {
+        return findValue(mFragment, key);
+    }
+    std::string fragmentValue(std::string_view key, const std::string &fallback) const {
+        return fragmentValue(key).value_or(fallback);
+    }
+
+    /**
+     * Calls fn(key, value) with raw, still encoded views of every key-value pair in a query or fragment,
+     * until fn returns false. A pair without "=" has an empty value.
+     *
+     * @param pairs Query or fragment, e.g. query()
+     * @param fn Callback bool(std::string_view key, std::string_view value)
+     */
+    template<typename F>
+    static void forEachPair(std::string_view pairs, F &&fn) {
+        for (auto part : Str::tokenize(pairs, "&")) {
+            auto [ key, value ] = splitTwo(part, "=");
+            if (!fn(key, value))
+                return;
+        }
+    }
+
+protected:
+    static std::pair<std::string_view, std::string_view> splitTwo(std::string_view str, std::string_view delim);
+    static std::optional<std::string> findValue(std::string_view pairs, std::string_view key);
+
+    std::string_view mSchema;
+    std::string_view mHost;
+    std::string_view mPath;
+    std::string_view mQuery;
+    std::string_view mFragment;
+};
+
+#endif //COMMONS_URIVIEW_H
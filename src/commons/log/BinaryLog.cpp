@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/BinaryLog.h>
+#include <commons/log/impl/FileLogger.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    // full chunks waiting for the background thread before logging threads block
+    constexpr size_t MAX_PENDING_CHUNKS = 16;
+}
+
+BinaryLogger::BinaryLogger(const std::string &filename, size_t bufferSize)
+        : mId(mNextId.fetch_add(1, std::memory_order_relaxed)), mBufferSize(bufferSize) {
+    mFile.open(filename, std::ios_base::app | std::ios_base::binary);
+
+    // new session, site ids of previous sessions in this file are meaningless
+    mFile.write(BinaryLogFormat::MAGIC, sizeof(BinaryLogFormat::MAGIC));
+
+    mThread = std::thread(&BinaryLogger::writeEntry, this);
+}
+
+BinaryLogger::~BinaryLogger() {
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStopped = true;
+        mCond.notify_all();
+    }
+    if (mThread.joinable())
+        mThread.join();
+
+    flush();
+}
+
+void BinaryLogger::flush() {
+    std::unique_lock<std::mutex> fileLock(mFileMutex);
+
+    std::vector<Chunk *> pending;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        pending.swap(mPending);
+        buffers = mThreadBuffers;
+    }
+
+    for (Chunk *chunk : pending)
+        writeChunk(chunk);
+
+    // active chunks are written up to their last complete record, their threads keep appending behind it
+    std::vector<std::shared_ptr<ThreadBuffer>> abandoned;
+    for (auto &buffer : buffers) {
+        if (buffer->abandoned.load(std::memory_order_acquire))
+            abandoned.push_back(buffer);
+        writeChunk(buffer->active.load(std::memory_order_acquire));
+    }
+    mFile.flush();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (Chunk *chunk : pending)
+        recycleChunk(chunk);
+    for (auto &buffer : abandoned) {
+        recycleChunk(buffer->active.load(std::memory_order_relaxed));
+        mThreadBuffers.erase(std::find(mThreadBuffers.begin(), mThreadBuffers.end(), buffer));
+    }
+    mCond.notify_all();
+}
+
+/*static*/ size_t BinaryLogger::siteSize(const BinaryLogSite &site) {
+    return 1 + 3 * sizeof(uint32_t) + 1 + sizeof(uint32_t) + std::strlen(site.file()) + std::strlen(site.format());
+}
+
+/*static*/ char *BinaryLogger::putSite(char *out, const BinaryLogSite &site) {
+    out = put<uint8_t>(out, BinaryLogFormat::ENTRY_SITE);
+    out = put<uint32_t>(out, site.id());
+    out = put<uint8_t>(out, static_cast<uint8_t>(site.level()));
+    out = put<uint32_t>(out, site.line());
+    out = putBytes(out, site.file());
+    return putBytes(out, site.format());
+}
+
+BinaryLogger::ThreadBuffer &BinaryLogger::registerThread() {
+    // forget buffers of destroyed loggers
+    auto &entries = mLocalBuffers.entries;
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [] (const auto &entry) {
+        return entry.second.use_count() == 1;
+    }), entries.end());
+
+    auto buffer = std::make_shared<ThreadBuffer>();
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        buffer->active.store(takeChunk(mBufferSize), std::memory_order_relaxed);
+        mThreadBuffers.push_back(buffer);
+    }
+
+    entries.emplace_back(mId, buffer);
+    return *buffer;
+}
+
+BinaryLogger::Chunk *BinaryLogger::nextChunk(ThreadBuffer &buffer, size_t minSize) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    Chunk *full = buffer.active.load(std::memory_order_relaxed);
+
+    if (full->committed.load(std::memory_order_relaxed) > 0) {
+        mPending.push_back(full);
+        mCond.notify_all();
+
+        // back pressure if the file cannot keep up
+        mCond.wait(lock, [this] () { return mPending.size() < MAX_PENDING_CHUNKS || mStopped; });
+    }
+    else
+        recycleChunk(full);
+
+    Chunk *chunk = takeChunk(std::max(minSize, mBufferSize));
+    buffer.active.store(chunk, std::memory_order_release);
+    buffer.sitesDescribed.assign(buffer.sitesDescribed.size(), false);
+    return chunk;
+}
+
+BinaryLogger::Chunk *BinaryLogger::takeChunk(size_t minSize) {
+    auto it = std::find_if(mFree.begin(), mFree.end(), [minSize] (Chunk *chunk) {
+        return chunk->capacity >= minSize;
+    });
+    if (it != mFree.end()) {
+        Chunk *chunk = *it;
+        mFree.erase(it);
+        return chunk;
+    }
+
+    mChunks.push_back(std::make_unique<Chunk>(minSize));
+    return mChunks.back().get();
+}
+
+void BinaryLogger::recycleChunk(Chunk *chunk) {
+    chunk->committed.store(0, std::memory_order_relaxed);
+    chunk->written = 0;
+    mFree.push_back(chunk);
+}
+
+void BinaryLogger::writeChunk(Chunk *chunk) {
+    size_t committed = chunk->committed.load(std::memory_order_acquire);
+    if (mFile.is_open() && committed > chunk->written)
+        mFile.write(chunk->data.get() + chunk->written, static_cast<std::streamsize>(committed - chunk->written));
+    chunk->written = committed;
+}
+
+void BinaryLogger::writeEntry() {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mStopped) {
+        mCond.wait(lock, [this] () { return mStopped || !mPending.empty(); });
+        if (mStopped)
+            break;
+        lock.unlock();
+
+        {
+            // lock order is mFileMutex before mMutex
+            std::unique_lock<std::mutex> fileLock(mFileMutex);
+            std::vector<Chunk *> pending;
+            {
+                std::unique_lock<std::mutex> chunkLock(mMutex);
+                pending.swap(mPending);
+            }
+
+            for (Chunk *chunk : pending)
+                writeChunk(chunk);
+
+            std::unique_lock<std::mutex> chunkLock(mMutex);
+            for (Chunk *chunk : pending)
+                recycleChunk(chunk);
+            mCond.notify_all();
+        }
+
+        lock.lock();
+    }
+}
+
+namespace {
+    template<typename T>
+    bool get(std::istream &in, T &value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+
+    bool getBytes(std::istream &in, std::string &value) {
+        uint32_t size;
+        if (!get(in, size))
+            return false;
+
+        value.resize(size);
+        return static_cast<bool>(in.read(&value[0], size));
+    }
+
+    // formats a single argument like the log streams would
+    bool formatArg(std::istream &in, std::ostream &out) {
+        using namespace BinaryLogFormat;
+
+        uint8_t tag;
+        if (!get(in, tag))
+            return false;
+
+        switch (tag) {
+            case ARG_INT: {
+                int64_t value;
+                if (!get(in, value)) return false;
+                out << value;
+                return true;
+            }
+            case ARG_UINT: {
+                uint64_t value;
+                if (!get(in, value)) return false;
+                out << value;
+                return true;
+            }
+            case ARG_DOUBLE: {
+                double value;
+                if (!get(in, value)) return false;
+                out << value;
+                return true;
+            }
+            case ARG_BOOL: {
+                uint8_t value;
+                if (!get(in, value)) return false;
+                out << (value != 0);
+                return true;
+            }
+            case ARG_CHAR: {
+                uint8_t value;
+                if (!get(in, value)) return false;
+                out << static_cast<char>(value);
+                return true;
+            }
+            case ARG_STRING: {
+                std::string value;
+                if (!getBytes(in, value)) return false;
+                out << value;
+                return true;
+            }
+            case ARG_POINTER: {
+                uint64_t value;
+                if (!get(in, value)) return false;
+                out << reinterpret_cast<const void *>(static_cast<uintptr_t>(value));
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+}
+
+/*static*/ bool BinaryLogDecoder::decode(std::istream &in, std::ostream &out) {
+    using namespace BinaryLogFormat;
+
+    struct Site {
+        LogLevel level;
+        std::string format;
+    };
+    std::unordered_map<uint32_t, Site> sites;
+    std::stringstream bruce;
+
+    for (int type; (type = in.peek()) != std::char_traits<char>::eof(); ) {
+        if (type == MAGIC[0]) {
+            char magic[sizeof(MAGIC)];
+            if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+                return false;
+
+            // ids restart with every session
+            sites.clear();
+        }
+        else if (type == ENTRY_SITE) {
+            in.get();
+
+            uint32_t id, line;
+            uint8_t level;
+            std::string file, format;
+            if (!get(in, id) || !get(in, level) || !get(in, line) || !getBytes(in, file) || !getBytes(in, format))
+                return false;
+
+            sites[id] = {static_cast<LogLevel>(level), std::move(format)};
+        }
+        else if (type == ENTRY_RECORD) {
+            in.get();
+
+            uint32_t id;
+            int64_t timestamp;
+            uint8_t argc;
+            if (!get(in, id) || !get(in, timestamp) || !get(in, argc))
+                return false;
+
+            auto it = sites.find(id);
+            if (it == sites.end())
+                return false;
+
+            // substitute arguments for placeholders, append surplus arguments
+            const std::string &format = it->second.format;
+            bruce.str(std::string());
+            size_t pos = 0;
+            for (uint8_t i = 0; i < argc; i++) {
+                size_t next = format.find("{}", pos);
+                if (next == std::string::npos) {
+                    bruce << format.substr(pos) << ' ';
+                    pos = format.size();
+                }
+                else {
+                    bruce << format.substr(pos, next - pos);
+                    pos = next + 2;
+                }
+
+                if (!formatArg(in, bruce))
+                    return false;
+            }
+            bruce << format.substr(pos);
+
+            FileLogger::writePrefix(out, timestamp, it->second.level);
+            out << bruce.str() << '\n';
+        }
+        else
+            return false;
+    }
+    return true;
+}
@@ -18,20 +18,150 @@
  */
 
 #include "commons/log/Log.h"
+#include "commons/log/AsyncLogWorker.h"
+#include "commons/log/LogTag.h"
 
 #include <algorithm>
+#include <thread>
+
+Log::Log() = default;
+
+Log::~Log() {
+    // write pending records and the note of collapsed repeats on shutdown
+    disableAsync();
+    flush();
+}
 
 void Log::registerLogger(ILogger *logger) {
+    std::unique_lock<std::mutex> lock(mLogLock);
+
     if (logger->isOpen() || logger->open())
         mLoggers.push_back(logger);
 }
 
 void Log::unregisterLogger(ILogger *logger) {
+    // records already logged may still be written to this logger
+    flush();
+    std::unique_lock<std::mutex> lock(mLogLock);
+
     if (logger->isOpen())
         logger->close();
     mLoggers.erase(std::remove(mLoggers.begin(), mLoggers.end(), logger), mLoggers.end());
 }
 
+void Log::enableAsync(size_t capacity, AsyncFullPolicy policy) {
+    std::unique_lock<std::mutex> lock(mAsyncLock);
+    if (mAsyncWorker)
+        return;
+
+    mAsyncCapacity = std::max<size_t>(capacity, 1);
+    mAsyncPolicy = policy;
+    mAsyncWorker = std::make_unique<AsyncLogWorker>(*this);
+    mAsyncWorker->startThread();
+    mAsync.store(true);
+}
+
+void Log::disableAsync() {
+    std::unique_lock<std::mutex> lock(mAsyncLock);
+    if (!mAsyncWorker)
+        return;
+
+    // new records are written synchronously, wait for the ones in flight
+    mAsync.store(false);
+    waitPending(0);
+
+    mAsyncWorker->stopThread();
+    mAsyncWorker->drain();
+    mAsyncWorker.reset();
+}
+
+void Log::flush() {
+    if (mAsync.load())
+        waitPending(0);
+
+    std::unique_lock<std::mutex> lock(mLogLock);
+    writeRepeats();
+}
+
+void Log::setCollapseRepeats(bool value) {
+    std::unique_lock<std::mutex> lock(mLogLock);
+
+    writeRepeats();
+    mCollapseRepeats = value;
+    mLastLevel = LogLevel::VALUE_INVALID;
+    mLastRecord.clear();
+}
+
+Log::RecordMode Log::beginRecord() {
+    while (mAsync.load()) {
+        // reserve first, so that disableAsync either sees the reservation or this thread sees async disabled
+        size_t pending = mAsyncPending.fetch_add(1);
+        if (!mAsync.load())
+            mAsyncPending.fetch_sub(1);
+        else if (pending < mAsyncCapacity)
+            return RecordMode::Async;
+        else {
+            mAsyncPending.fetch_sub(1);
+            if (mAsyncPolicy == AsyncFullPolicy::Drop) {
+                mAsyncDropped.fetch_add(1, std::memory_order_relaxed);
+                return RecordMode::Skip;
+            }
+
+            // wait for the worker to make room and try again
+            waitPending(mAsyncCapacity - 1);
+        }
+    }
+    return RecordMode::Sync;
+}
+
+void Log::submitAsync(LogLevel level, std::string_view record, const LogRecordContext &context) {
+    mAsyncWorker->enqueue({level, std::string(record), context.prefixSize, std::string(context.fields)});
+}
+
+void Log::writeRecord(LogLevel level, std::string_view record, const LogRecordContext &context) {
+    std::unique_lock<std::mutex> lock(mLogLock);
+
+    if (mCollapseRepeats) {
+        if (level == mLastLevel && record == mLastRecord) {
+            mRepeats++;
+            return;
+        }
+
+        writeRepeats();
+        // keeps its capacity, so this does not allocate once warmed up
+        mLastLevel = level;
+        mLastRecord.assign(record);
+    }
+
+    for (ILogger *logger: loggers())
+        logger->writeWithContext(record, level, context);
+}
+
+void Log::updateTagLevels() {
+    LogTagTable::get().setGlobal(mLevelBits);
+}
+
+void Log::writeRepeats() {
+    if (mRepeats == 0)
+        return;
+
+    // a single repeat is written as the record itself
+    std::string note = mRepeats == 1 ? mLastRecord : "Last message repeated " + std::to_string(mRepeats) + " times";
+    mRepeats = 0;
+    for (ILogger *logger: loggers())
+        logger->write(note, mLastLevel);
+}
+
+void Log::waitPending(size_t limit) {
+    // the worker writes far faster than a sleep granularity, so yield first and back off later
+    for (int spins = 0; mAsyncPending.load() > limit; spins++) {
+        if (spins < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
 Log::LogStream<LogLevel::LEVEL_TRACE> Log::trac(Log::mInstance);
 Log::LogStream<LogLevel::LEVEL_DEBUG> Log::dbg(Log::mInstance);
 Log::LogStream<LogLevel::LEVEL_INFO> Log::info(Log::mInstance);
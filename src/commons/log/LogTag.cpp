@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/LogTag.h>
+
+LogTagTable::LogTagTable() {
+    for (auto &bits : mBits)
+        bits.store(mGlobalBits, std::memory_order_relaxed);
+}
+
+void LogTagTable::setLevel(std::string_view tag, LogLevel level) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    size_t index = findOrAdd(tag);
+    if (index >= mEntries.size())
+        return;
+
+    mEntries[index].overridden = true;
+    mEntries[index].levelBits = level == LogLevel::VALUE_INVALID ? 0 : Log::levelMask(level);
+    apply(index);
+}
+
+void LogTagTable::resetLevel(std::string_view tag) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    size_t index = findOrAdd(tag);
+    if (index >= mEntries.size())
+        return;
+
+    mEntries[index].overridden = false;
+    apply(index);
+}
+
+void LogTagTable::resetAll() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (size_t i = 0; i < mEntries.size(); i++) {
+        mEntries[i].overridden = false;
+        apply(i);
+    }
+}
+
+std::vector<std::string> LogTagTable::tags() const {
+    std::unique_lock<std::mutex> lock(mMutex);
+    std::vector<std::string> result;
+    for (const auto &entry : mEntries)
+        result.push_back(entry.name);
+    return result;
+}
+
+std::atomic<uint8_t> &LogTagTable::registerTag(std::string_view tag) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mBits[findOrAdd(tag)];
+}
+
+void LogTagTable::setGlobal(const std::atomic<uint8_t> &bits) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    // loaded with the lock held, so concurrent level changes are applied in order
+    mGlobalBits = bits.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < mEntries.size(); i++)
+        apply(i);
+    mBits[MAX_TAGS].store(mGlobalBits, std::memory_order_relaxed);
+}
+
+size_t LogTagTable::findOrAdd(std::string_view tag) {
+    for (size_t i = 0; i < mEntries.size(); i++)
+        if (mEntries[i].name == tag)
+            return i;
+
+    if (mEntries.size() == MAX_TAGS)
+        return MAX_TAGS;
+
+    mEntries.push_back({std::string(tag)});
+    apply(mEntries.size() - 1);
+    return mEntries.size() - 1;
+}
+
+void LogTagTable::apply(size_t index) {
+    const Entry &entry = mEntries[index];
+    uint8_t globalEnabled = mGlobalBits & Log::GLOBAL_ENABLED_BIT;
+    uint8_t levelBits = entry.overridden ? entry.levelBits : mGlobalBits & ~Log::GLOBAL_ENABLED_BIT;
+
+    mBits[index].store(levelBits | globalEnabled, std::memory_order_relaxed);
+}
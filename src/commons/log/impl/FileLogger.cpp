@@ -19,9 +19,32 @@
 
 #include <commons/log/impl/FileLogger.h>
 #include <commons/util/Time.h>
+#include <commons/util/TimestampCache.h>
+
+#include <algorithm>
+#include <iterator>
 
 
 bool FileLogger::wantsLog(LogLevel level) {
-    mFile << Time::nowLocal().formatFull("%Y-%m-%dT%H:%M:%S%z") << " [" << level << "] ";
+    writePrefix(mFile, CoarseClock::logNow(), level);
     return true;
 }
+
+void FileLogger::writePrefix(std::ostream &os, int64_t timestamp, LogLevel level) {
+    // formatting the time is only needed once per second
+    thread_local TimestampCache cache("%Y-%m-%dT%H:%M:%S%z");
+    // level names are built once instead of per record
+    static const std::string levelNames[] = {
+            " [" + toString(LogLevel::LEVEL_TRACE) + "] ",
+            " [" + toString(LogLevel::LEVEL_DEBUG) + "] ",
+            " [" + toString(LogLevel::LEVEL_INFO) + "] ",
+            " [" + toString(LogLevel::LEVEL_WARNING) + "] ",
+            " [" + toString(LogLevel::LEVEL_ERROR) + "] ",
+            " [" + toString(LogLevel::VALUE_INVALID) + "] ",
+    };
+
+    std::string_view time = cache.format(timestamp);
+    const std::string &name = levelNames[std::min<size_t>(static_cast<size_t>(level), std::size(levelNames) - 1)];
+    os.write(time.data(), static_cast<std::streamsize>(time.size()));
+    os.write(name.data(), static_cast<std::streamsize>(name.size()));
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/impl/FlightRecorderLogger.h>
+#include <commons/log/impl/FileLogger.h>
+#include <commons/util/Time.h>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <vector>
+
+#ifndef WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static_assert(sizeof(FlightRecorderLogger::FileHeader) == 64, "Header must keep the data area aligned");
+static_assert(sizeof(FlightRecorderLogger::RecordHeader) % 8 == 0, "Record header must keep records aligned");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory requires lock-free atomics");
+
+namespace {
+    constexpr uint64_t align8(uint64_t value) {
+        return (value + 7) & ~uint64_t(7);
+    }
+}
+
+FlightRecorderLogger::FlightRecorderLogger(std::string filename, size_t capacity) : mFilename(std::move(filename)) {
+    mCapacity = 4096;
+    while (mCapacity < capacity)
+        mCapacity *= 2;
+
+    open();
+}
+
+FlightRecorderLogger::~FlightRecorderLogger() {
+    close();
+}
+
+bool FlightRecorderLogger::open() {
+#ifndef WIN32
+    if (mMap)
+        return true;
+
+    mFd = ::open(mFilename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (mFd < 0)
+        return false;
+
+    // reuse the file only if it has the expected layout, otherwise start over
+    FileHeader header {};
+    mMapSize = sizeof(FileHeader) + mCapacity;
+    bool valid = ::pread(mFd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+            && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION
+            && header.headerSize == sizeof(FileHeader) && header.capacity == mCapacity;
+
+    struct stat st {};
+    if ((!valid && ::ftruncate(mFd, 0) != 0) || ::fstat(mFd, &st) != 0
+            || (static_cast<size_t>(st.st_size) != mMapSize && ::ftruncate(mFd, static_cast<off_t>(mMapSize)) != 0)) {
+        close();
+        return false;
+    }
+
+    void *map = ::mmap(nullptr, mMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+    if (map == MAP_FAILED) {
+        close();
+        return false;
+    }
+    mMap = static_cast<char *>(map);
+    mData = mMap + sizeof(FileHeader);
+
+    auto *mapped = reinterpret_cast<FileHeader *>(mMap);
+    if (!valid) {
+        std::memcpy(mapped->magic, MAGIC, sizeof(MAGIC));
+        mapped->version = VERSION;
+        mapped->headerSize = sizeof(FileHeader);
+        mapped->capacity = mCapacity;
+        mapped->writePos = 0;
+    }
+    mWritePos = reinterpret_cast<std::atomic<uint64_t> *>(&mapped->writePos);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FlightRecorderLogger::close() {
+#ifndef WIN32
+    if (mMap)
+        ::munmap(mMap, mMapSize);
+    if (mFd >= 0)
+        ::close(mFd);
+#endif
+    mMap = mData = nullptr;
+    mWritePos = nullptr;
+    mFd = -1;
+}
+
+bool FlightRecorderLogger::isOpen() {
+    return mMap != nullptr;
+}
+
+void FlightRecorderLogger::write(std::string_view record, LogLevel level) {
+    if (!mMap)
+        return;
+
+    record = record.substr(0, mCapacity / 4);
+    uint32_t size = static_cast<uint32_t>(align8(sizeof(RecordHeader) + record.size()));
+    uint64_t pos = mWritePos->fetch_add(size, std::memory_order_relaxed);
+
+    RecordHeader header {};
+    header.size = size;
+    header.level = static_cast<uint8_t>(level);
+    header.padding = static_cast<uint8_t>(size - sizeof(RecordHeader) - record.size());
+    header.timestamp = CoarseClock::logNow();
+
+    // everything but the position, which commits the record
+    copyIn(pos + sizeof(header.pos), reinterpret_cast<const char *>(&header) + sizeof(header.pos),
+           sizeof(header) - sizeof(header.pos));
+    copyIn(pos + sizeof(header), record.data(), record.size());
+
+    // aligned and never wrapping, as records are aligned to 8 and the capacity is a power of two
+    auto *commit = reinterpret_cast<std::atomic<uint64_t> *>(mData + (pos & (mCapacity - 1)));
+    commit->store(pos, std::memory_order_release);
+}
+
+void FlightRecorderLogger::copyIn(uint64_t pos, const void *data, size_t size) {
+    size_t offset = pos & (mCapacity - 1);
+    size_t first = std::min(size, mCapacity - offset);
+
+    std::memcpy(mData + offset, data, first);
+    std::memcpy(mData, static_cast<const char *>(data) + first, size - first);
+}
+
+/*static*/ bool FlightRecorderReader::read(const std::string &filename, std::ostream &out, size_t maxRecords) {
+    using Header = FlightRecorderLogger::FileHeader;
+    using Record = FlightRecorderLogger::RecordHeader;
+
+    std::ifstream file(filename, std::ios_base::binary);
+    Header header {};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))
+            || std::memcmp(header.magic, FlightRecorderLogger::MAGIC, sizeof(header.magic)) != 0
+            || header.version != FlightRecorderLogger::VERSION || header.headerSize != sizeof(Header)
+            || header.capacity < 4096 || (header.capacity & (header.capacity - 1)) != 0)
+        return false;
+
+    std::vector<char> data(header.capacity);
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())))
+        return false;
+
+    uint64_t mask = header.capacity - 1;
+    auto copyOut = [&data, mask] (uint64_t pos, void *target, size_t size) {
+        size_t offset = pos & mask;
+        size_t first = std::min<size_t>(size, data.size() - offset);
+
+        std::memcpy(target, data.data() + offset, first);
+        std::memcpy(static_cast<char *>(target) + first, data.data(), size - first);
+    };
+
+    // only the last capacity bytes can still be intact, resynchronize on the next valid record after invalid data
+    struct Entry {
+        Record header;
+        std::string text;
+    };
+    std::deque<Entry> entries;
+    uint64_t end = header.writePos;
+    for (uint64_t pos = align8(end > header.capacity ? end - header.capacity : 0); pos + sizeof(Record) <= end; ) {
+        Entry entry {};
+        copyOut(pos, &entry.header, sizeof(Record));
+
+        uint32_t size = entry.header.size;
+        if (entry.header.pos != pos || size < sizeof(Record) + entry.header.padding || size % 8 != 0
+                || pos + size > end) {
+            pos += 8;
+            continue;
+        }
+
+        entry.text.resize(size - sizeof(Record) - entry.header.padding);
+        copyOut(pos + sizeof(Record), &entry.text[0], entry.text.size());
+
+        entries.push_back(std::move(entry));
+        if (maxRecords > 0 && entries.size() > maxRecords)
+            entries.pop_front();
+        pos += size;
+    }
+
+    for (const auto &entry : entries) {
+        FileLogger::writePrefix(out, entry.header.timestamp, static_cast<LogLevel>(entry.header.level));
+        out << entry.text << '\n';
+    }
+    return true;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/impl/JournaldLogger.h>
+#include <commons/log/impl/SystemdLogger.h>
+#include <commons/log/LogContext.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef WIN32
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+#ifdef __linux__
+    #include <sys/syscall.h>
+#endif
+
+namespace {
+    const std::string &threadId() {
+        thread_local std::string tid = [] () {
+#ifdef __linux__
+            return std::to_string(syscall(SYS_gettid));
+#elif !defined(WIN32)
+            return std::to_string(getpid());
+#else
+            return std::string();
+#endif
+        }();
+        return tid;
+    }
+
+    // journal field names consist of upper case letters, digits and underscores and must not start with underscore
+    void toFieldName(std::string &name, std::string_view key) {
+        name.clear();
+        for (char c : key) {
+            if (c >= 'a' && c <= 'z')
+                name.push_back(static_cast<char>(c - 'a' + 'A'));
+            else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || (c == '_' && !name.empty()))
+                name.push_back(c);
+            else if (!name.empty())
+                name.push_back('_');
+        }
+    }
+}
+
+JournaldLogger::JournaldLogger() : JournaldLogger(Config()) { }
+
+JournaldLogger::JournaldLogger(Config config) : mConfig(std::move(config)) {
+    if (mConfig.maxBatch == 0)
+        mConfig.maxBatch = 1;
+    open();
+}
+
+JournaldLogger::~JournaldLogger() {
+    close();
+}
+
+bool JournaldLogger::open() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mFd >= 0)
+        return true;
+    if (!connectSocket())
+        return false;
+
+    if (mConfig.flushIntervalMillis > 0 && mConfig.maxBatch > 1) {
+        mStopped = false;
+        mFlushThread = std::thread(&JournaldLogger::flushEntry, this);
+    }
+    return true;
+}
+
+void JournaldLogger::close() {
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStopped = true;
+        mFlushCond.notify_all();
+    }
+    if (mFlushThread.joinable())
+        mFlushThread.join();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mFd >= 0) {
+        sendBatch();
+#ifndef WIN32
+        ::close(mFd);
+#endif
+        mFd = -1;
+    }
+}
+
+bool JournaldLogger::isOpen() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mFd >= 0;
+}
+
+void JournaldLogger::flush() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    sendBatch();
+}
+
+void JournaldLogger::write(std::string_view record, LogLevel level) {
+    writeWithContext(record, level, LogRecordContext());
+}
+
+void JournaldLogger::writeWithContext(std::string_view record, LogLevel level, const LogRecordContext &context) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mFd < 0)
+        return;
+
+    if (mBatchSize == mBatch.size())
+        mBatch.emplace_back();
+    std::string &entry = mBatch[mBatchSize++];
+
+    entry.clear();
+    appendField(entry, "PRIORITY", std::to_string(static_cast<int>(SystemdLogger::toSystemdLevel(level))));
+    if (!mConfig.identifier.empty())
+        appendField(entry, "SYSLOG_IDENTIFIER", mConfig.identifier);
+    if (!threadId().empty())
+        appendField(entry, "TID", threadId());
+    LogContext::forEachField(context.fields, [this, &entry] (std::string_view key, std::string_view value) {
+        toFieldName(mFieldName, key);
+        if (!mFieldName.empty())
+            appendField(entry, mFieldName, value);
+    });
+    appendField(entry, "MESSAGE", record.substr(std::min(context.prefixSize, record.size())));
+
+    if (mBatchSize >= mConfig.maxBatch)
+        sendBatch();
+}
+
+void JournaldLogger::appendField(std::string &entry, std::string_view name, std::string_view value) {
+    entry.append(name);
+
+    if (value.find('\n') == std::string_view::npos) {
+        entry.push_back('=');
+        entry.append(value);
+    } else {
+        // binary form: name, newline, 64 bit little endian size, value
+        entry.push_back('\n');
+        uint64_t size = value.size();
+        for (int i = 0; i < 8; i++)
+            entry.push_back(static_cast<char>((size >> (i * 8)) & 0xff));
+        entry.append(value);
+    }
+    entry.push_back('\n');
+}
+
+bool JournaldLogger::connectSocket() {
+#ifndef WIN32
+    sockaddr_un address {};
+    if (mConfig.socketPath.size() >= sizeof(address.sun_path))
+        return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, mConfig.socketPath.data(), mConfig.socketPath.size());
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return false;
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    // journald recommends a large send buffer so entries are not truncated, best effort
+    int bufferSize = 8 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (mFd >= 0)
+        ::close(mFd);
+    mFd = fd;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void JournaldLogger::sendBatch() {
+#ifndef WIN32
+    size_t sent = 0;
+    bool reconnected = false;
+
+    while (mFd >= 0 && sent < mBatchSize) {
+        ssize_t result;
+#ifdef __linux__
+        mmsghdr messages[64] {};
+        iovec vectors[64] {};
+        size_t count = std::min<size_t>(mBatchSize - sent, 64);
+        for (size_t i = 0; i < count; i++) {
+            vectors[i].iov_base = mBatch[sent + i].data();
+            vectors[i].iov_len = mBatch[sent + i].size();
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        result = sendmmsg(mFd, messages, static_cast<unsigned>(count), MSG_NOSIGNAL);
+#else
+        const std::string &entry = mBatch[sent];
+        result = send(mFd, entry.data(), entry.size(), 0) >= 0 ? 1 : -1;
+#endif
+        if (result > 0) {
+            sent += static_cast<size_t>(result);
+            continue;
+        }
+        if (errno == EINTR)
+            continue;
+
+        // journald restarted, its socket was recreated
+        if (!reconnected && (errno == ECONNREFUSED || errno == ENOTCONN || errno == ENOENT)) {
+            reconnected = true;
+            if (connectSocket())
+                continue;
+        }
+
+        // entry cannot be sent, e.g. too large, skip it
+        mFailed.fetch_add(1, std::memory_order_relaxed);
+        sent++;
+    }
+
+    mFailed.fetch_add(mBatchSize - sent, std::memory_order_relaxed);
+#endif
+    mBatchSize = 0;
+}
+
+void JournaldLogger::flushEntry() {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mStopped) {
+        mFlushCond.wait_for(lock, std::chrono::milliseconds(mConfig.flushIntervalMillis));
+        sendBatch();
+    }
+}
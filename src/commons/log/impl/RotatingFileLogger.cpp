@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/impl/RotatingFileLogger.h>
+#include <commons/log/impl/FileLogger.h>
+#include <commons/util/Time.h>
+#include <commons/util/Timer.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#ifdef WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+#ifdef COMMONS_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace {
+    void syncFile(std::FILE *file) {
+#if defined(WIN32)
+        _commit(_fileno(file));
+#elif defined(__APPLE__)
+        fsync(fileno(file));
+#else
+        fdatasync(fileno(file));
+#endif
+    }
+
+    bool compressFile(const std::string &from, const std::string &to) {
+#ifdef COMMONS_HAVE_ZLIB
+        std::FILE *in = std::fopen(from.c_str(), "rb");
+        if (!in)
+            return false;
+
+        gzFile out = gzopen(to.c_str(), "wb");
+        if (!out) {
+            std::fclose(in);
+            return false;
+        }
+
+        std::vector<char> buffer(64 * 1024);
+        bool success = true;
+        for (size_t read; success && (read = std::fread(buffer.data(), 1, buffer.size(), in)) > 0; )
+            success = gzwrite(out, buffer.data(), static_cast<unsigned>(read)) == static_cast<int>(read);
+
+        success = !std::ferror(in) && gzclose(out) == Z_OK && success;
+        std::fclose(in);
+
+        if (!success)
+            std::remove(to.c_str());
+        return success;
+#else
+        (void) from;
+        (void) to;
+        return false;
+#endif
+    }
+
+    void moveFile(const std::string &from, const std::string &to) {
+        // rename does not replace existing files on all platforms
+        std::remove(to.c_str());
+        std::rename(from.c_str(), to.c_str());
+    }
+}
+
+RotatingFileLogger::RotatingFileLogger(std::string filename, Config config)
+        : mFilename(std::move(filename)), mConfig(config) {
+    open();
+}
+
+RotatingFileLogger::RotatingFileLogger(std::string filename) : RotatingFileLogger(std::move(filename), Config()) { }
+
+RotatingFileLogger::~RotatingFileLogger() {
+    close();
+}
+
+bool RotatingFileLogger::open() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mFile)
+        return true;
+    // threads are still running after a failed reopen
+    if (mReopen)
+        return reopenFile(true);
+    if (!openFile())
+        return false;
+
+    if (mConfig.compress && compressionSupported()) {
+        mRotateWorker = std::make_unique<RotateWorker>(*this);
+        mRotateWorker->startThread();
+    }
+    if (mConfig.flushIntervalMillis > 0) {
+        mStopped = false;
+        mFlushThread = std::thread(&RotatingFileLogger::flushEntry, this);
+    }
+    return true;
+}
+
+void RotatingFileLogger::close() {
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStopped = true;
+        mFlushCond.notify_all();
+    }
+    if (mFlushThread.joinable())
+        mFlushThread.join();
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mFile) {
+            writeBuffer();
+            closeFile();
+        }
+        mReopen = false;
+    }
+
+    // finish compressing all rotated files
+    if (mRotateWorker) {
+        mRotateWorker->stopThread();
+        mRotateWorker->drain();
+        mRotateWorker.reset();
+    }
+}
+
+bool RotatingFileLogger::isOpen() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mFile != nullptr;
+}
+
+void RotatingFileLogger::flush() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mFile || reopenFile(false))
+        writeBuffer();
+}
+
+void RotatingFileLogger::write(std::string_view record, LogLevel level) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (!mFile && !reopenFile(false)) {
+        if (mReopen)
+            mDropped++;
+        return;
+    }
+
+    FileLogger::writePrefix(mBuffer, CoarseClock::logNow(), level);
+    mBuffer.write(record.data(), static_cast<std::streamsize>(record.size()));
+    mBuffer.put('\n');
+
+    size_t buffered = mBuffer.view().size();
+    if ((mConfig.maxBytes > 0 && mFileBytes + buffered >= mConfig.maxBytes)
+            || (mConfig.maxAgeMillis > 0 && Timer::steadyNowCoarse() - mOpenedAt >= mConfig.maxAgeMillis))
+        rotateFile();
+    else if (buffered >= mConfig.bufferBytes)
+        writeBuffer();
+}
+
+void RotatingFileLogger::rotate() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mFile)
+        rotateFile();
+}
+
+/*static*/ bool RotatingFileLogger::compressionSupported() {
+#ifdef COMMONS_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string RotatingFileLogger::rotatedName(size_t index) const {
+    std::string name = mFilename + "." + std::to_string(index);
+    if (mConfig.compress && compressionSupported())
+        name += ".gz";
+    return name;
+}
+
+bool RotatingFileLogger::openFile() {
+    mFile = std::fopen(mFilename.c_str(), "ab");
+    if (!mFile)
+        return false;
+
+    // records are buffered in mBuffer already
+    std::setvbuf(mFile, nullptr, _IONBF, 0);
+
+    std::fseek(mFile, 0, SEEK_END);
+    long size = std::ftell(mFile);
+    mFileBytes = size > 0 ? static_cast<size_t>(size) : 0;
+    mOpenedAt = Timer::steadyNowCoarse();
+    return true;
+}
+
+bool RotatingFileLogger::reopenFile(bool force) {
+    if (!mReopen || (!force && Timer::steadyNowCoarse() < mReopenAt))
+        return false;
+
+    if (!openFile()) {
+        mReopenAt = Timer::steadyNowCoarse() + mConfig.reopenIntervalMillis;
+        return false;
+    }
+    mReopen = false;
+
+    if (mDropped > 0) {
+        std::stringstream bruce;
+        bruce << "Dropped " << mDropped << " records while the log file could not be opened";
+        std::string note = bruce.str();
+
+        FileLogger::writePrefix(mBuffer, CoarseClock::logNow(), LogLevel::LEVEL_WARNING);
+        mBuffer.write(note.data(), static_cast<std::streamsize>(note.size()));
+        mBuffer.put('\n');
+        mDropped = 0;
+    }
+    return true;
+}
+
+void RotatingFileLogger::closeFile() {
+    if (mConfig.sync != SyncPolicy::None)
+        syncFile(mFile);
+
+    std::fclose(mFile);
+    mFile = nullptr;
+}
+
+void RotatingFileLogger::writeBuffer() {
+    std::string_view data = mBuffer.view();
+    if (data.empty())
+        return;
+
+    mFileBytes += std::fwrite(data.data(), 1, data.size(), mFile);
+    mBuffer.reset();
+
+    if (mConfig.sync == SyncPolicy::Flush)
+        syncFile(mFile);
+}
+
+void RotatingFileLogger::rotateFile() {
+    writeBuffer();
+    closeFile();
+
+    // move the file out of the way, renaming and compressing rotated files may take a while
+    std::string pending = mFilename + ".pending." + std::to_string(mRotations++);
+    moveFile(mFilename, pending);
+
+    if (mRotateWorker)
+        mRotateWorker->enqueue(pending);
+    else
+        shiftRotated(pending);
+
+    if (!openFile()) {
+        // the logger cannot log its own failure
+        std::fprintf(stderr, "Failed to reopen log file %s: %s\n", mFilename.c_str(), std::strerror(errno));
+        mReopen = true;
+        mReopenAt = Timer::steadyNowCoarse() + mConfig.reopenIntervalMillis;
+    }
+}
+
+void RotatingFileLogger::shiftRotated(const std::string &pending) {
+    if (mConfig.keepFiles == 0) {
+        std::remove(pending.c_str());
+        return;
+    }
+
+    bool compress = mConfig.compress && compressionSupported();
+    std::remove(rotatedName(mConfig.keepFiles).c_str());
+    if (compress)
+        std::remove(uncompressedName(mConfig.keepFiles).c_str());
+
+    for (size_t i = mConfig.keepFiles - 1; i >= 1; i--) {
+        std::rename(rotatedName(i).c_str(), rotatedName(i + 1).c_str());
+        if (compress)
+            std::rename(uncompressedName(i).c_str(), uncompressedName(i + 1).c_str());
+    }
+
+    if (compress) {
+        if (compressFile(pending, rotatedName(1))) {
+            std::remove(pending.c_str());
+            return;
+        }
+        // keep the data uncompressed, it is shifted like the compressed files
+        moveFile(pending, uncompressedName(1));
+    }
+    else
+        moveFile(pending, rotatedName(1));
+}
+
+std::string RotatingFileLogger::uncompressedName(size_t index) const {
+    return mFilename + "." + std::to_string(index);
+}
+
+void RotatingFileLogger::flushEntry() {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mStopped) {
+        mFlushCond.wait_for(lock, std::chrono::milliseconds(mConfig.flushIntervalMillis));
+        if (!mStopped && (mFile || reopenFile(false)))
+            writeBuffer();
+    }
+}
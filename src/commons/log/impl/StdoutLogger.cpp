@@ -18,10 +18,12 @@
  */
 
 #include <commons/log/impl/StdoutLogger.h>
+#include <commons/log/impl/FileLogger.h>
 #include <commons/util/Time.h>
 
 
 bool StdoutLogger::wantsLog(LogLevel level) {
-    std::cout << Time::nowLocal().formatFull("%Y-%m-%dT%H:%M:%S%z") << " [" << level << "] ";
+    // same prefix as in log files
+    FileLogger::writePrefix(std::cout, CoarseClock::logNow(), level);
     return true;
 }
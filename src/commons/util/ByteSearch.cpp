@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/util/ByteSearch.h>
+
+#include <atomic>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define COMMONS_BYTESEARCH_X86 1
+    #include <immintrin.h>
+#else
+    #define COMMONS_BYTESEARCH_X86 0
+#endif
+
+struct ByteSearchKernels {
+    const char *name;
+    size_t (*search)(const uint8_t *data, size_t size, const ByteSet &set, bool negate);
+    size_t (*count)(const uint8_t *data, size_t size, const ByteSet &set);
+    size_t (*find)(const char *data, size_t size, const char *needle, size_t needleSize);
+
+    static size_t searchScalar(const uint8_t *data, size_t size, const ByteSet &set, bool negate) {
+        return ByteSearch::searchScalar(data, size, set, negate);
+    }
+
+    static size_t countScalar(const uint8_t *data, size_t size, const ByteSet &set) {
+        size_t result = 0;
+        for (size_t i = 0; i < size; i++)
+            result += set.contains(data[i]);
+        return result;
+    }
+
+    static size_t findScalar(const char *data, size_t size, const char *needle, size_t needleSize) {
+        size_t found = std::string_view(data, size).find(std::string_view(needle, needleSize));
+        return found == std::string_view::npos ? size : found;
+    }
+
+#if COMMONS_BYTESEARCH_X86
+    // SSE2: a byte matches if it lies in one of the contiguous ranges of the set
+
+    struct RangesSse2 {
+        __m128i first[ByteSet::MAX_RANGES];
+        __m128i length[ByteSet::MAX_RANGES];
+        int count;
+    };
+
+    __attribute__((target("sse2")))
+    static void loadRangesSse2(const ByteSet &set, RangesSse2 &ranges) {
+        ranges.count = set.mRangeCount;
+        for (int r = 0; r < ranges.count; r++) {
+            ranges.first[r] = _mm_set1_epi8(static_cast<char>(set.mRangeFirst[r]));
+            ranges.length[r] = _mm_set1_epi8(static_cast<char>(set.mRangeLength[r]));
+        }
+    }
+
+    __attribute__((target("sse2")))
+    static int matchSse2(const uint8_t *data, const RangesSse2 &ranges) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        __m128i result = _mm_setzero_si128();
+
+        // unsigned v - first <= length
+        for (int r = 0; r < ranges.count; r++) {
+            __m128i offset = _mm_sub_epi8(v, ranges.first[r]);
+            result = _mm_or_si128(result, _mm_cmpeq_epi8(_mm_max_epu8(offset, ranges.length[r]), ranges.length[r]));
+        }
+        return _mm_movemask_epi8(result);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t searchSse2(const uint8_t *data, size_t size, const ByteSet &set, bool negate) {
+        if (set.mRangeCount > ByteSet::MAX_RANGES || size < 16)
+            return searchScalar(data, size, set, negate);
+
+        RangesSse2 ranges;
+        loadRangesSse2(set, ranges);
+        int flip = negate ? 0xFFFF : 0;
+
+        for (size_t i = 0; i < size; i += 16) {
+            // last block overlaps the previous one instead of falling back to the scalar loop
+            if (i + 16 > size)
+                i = size - 16;
+
+            int mask = matchSse2(data + i, ranges) ^ flip;
+            if (mask)
+                return i + __builtin_ctz(mask);
+        }
+        return size;
+    }
+
+    __attribute__((target("sse2")))
+    static size_t countSse2(const uint8_t *data, size_t size, const ByteSet &set) {
+        if (set.mRangeCount > ByteSet::MAX_RANGES)
+            return countScalar(data, size, set);
+
+        RangesSse2 ranges;
+        loadRangesSse2(set, ranges);
+
+        size_t result = 0, i = 0;
+        for (; i + 16 <= size; i += 16)
+            result += __builtin_popcount(matchSse2(data + i, ranges));
+        return result + countScalar(data + i, size - i, set);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t findSse2(const char *data, size_t size, const char *needle, size_t needleSize) {
+        if (needleSize < 2)
+            return findScalar(data, size, needle, needleSize);
+
+        // candidates match the first and the last byte of needle
+        __m128i first = _mm_set1_epi8(needle[0]), last = _mm_set1_epi8(needle[needleSize - 1]);
+
+        size_t i = 0;
+        for (; i + needleSize - 1 + 16 <= size; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + needleSize - 1));
+
+            for (int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+                    mask; mask &= mask - 1) {
+                size_t at = i + __builtin_ctz(mask);
+                if (std::memcmp(data + at + 1, needle + 1, needleSize - 2) == 0)
+                    return at;
+            }
+        }
+        return i + findScalar(data + i, size - i, needle, needleSize);
+    }
+
+    // AVX2: a byte matches if its bit is set in the nibble tables of the set, which works for any set
+
+    struct TablesAvx2 {
+        __m256i low;
+        __m256i high;
+        __m256i bits;
+    };
+
+    __attribute__((target("avx2")))
+    static void loadTablesAvx2(const ByteSet &set, TablesAvx2 &tables) {
+        tables.low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.mNibbleLow)));
+        tables.high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.mNibbleHigh)));
+        tables.bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                       1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    }
+
+    __attribute__((target("avx2")))
+    static uint32_t matchAvx2(const uint8_t *data, const TablesAvx2 &tables) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+        __m256i low = _mm256_and_si256(v, nibbleMask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibbleMask);
+
+        // table row by low nibble, sign bit of the byte selects the table for high nibbles >= 8
+        __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(tables.low, low),
+                                         _mm256_shuffle_epi8(tables.high, low), v);
+        __m256i bit = _mm256_shuffle_epi8(tables.bits, high);
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+    }
+
+    __attribute__((target("avx2")))
+    static size_t searchAvx2(const uint8_t *data, size_t size, const ByteSet &set, bool negate) {
+        if (size < 32)
+            return searchSse2(data, size, set, negate);
+
+        TablesAvx2 tables;
+        loadTablesAvx2(set, tables);
+        uint32_t flip = negate ? 0xFFFFFFFF : 0;
+
+        for (size_t i = 0; i < size; i += 32) {
+            // last block overlaps the previous one instead of falling back to the scalar loop
+            if (i + 32 > size)
+                i = size - 32;
+
+            uint32_t mask = matchAvx2(data + i, tables) ^ flip;
+            if (mask)
+                return i + __builtin_ctz(mask);
+        }
+        return size;
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    static size_t countAvx2(const uint8_t *data, size_t size, const ByteSet &set) {
+        TablesAvx2 tables;
+        loadTablesAvx2(set, tables);
+
+        size_t result = 0, i = 0;
+        for (; i + 32 <= size; i += 32)
+            result += __builtin_popcount(matchAvx2(data + i, tables));
+        return result + countScalar(data + i, size - i, set);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t findAvx2(const char *data, size_t size, const char *needle, size_t needleSize) {
+        if (needleSize < 2)
+            return findScalar(data, size, needle, needleSize);
+
+        // candidates match the first and the last byte of needle
+        __m256i first = _mm256_set1_epi8(needle[0]), last = _mm256_set1_epi8(needle[needleSize - 1]);
+
+        size_t i = 0;
+        for (; i + needleSize - 1 + 32 <= size; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + needleSize - 1));
+
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+            for (; mask; mask &= mask - 1) {
+                size_t at = i + __builtin_ctz(mask);
+                if (std::memcmp(data + at + 1, needle + 1, needleSize - 2) == 0)
+                    return at;
+            }
+        }
+        return i + findSse2(data + i, size - i, needle, needleSize);
+    }
+#endif
+
+    static const ByteSearchKernels *byName(std::string_view name) {
+        static const ByteSearchKernels scalar = {"scalar", &searchScalar, &countScalar, &findScalar};
+#if COMMONS_BYTESEARCH_X86
+        static const ByteSearchKernels sse2 = {"sse2", &searchSse2, &countSse2, &findSse2};
+        static const ByteSearchKernels avx2 = {"avx2", &searchAvx2, &countAvx2, &findAvx2};
+
+        __builtin_cpu_init();
+        if (name == "avx2")
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ? &avx2 : nullptr;
+        if (name == "sse2")
+            return __builtin_cpu_supports("sse2") ? &sse2 : nullptr;
+#endif
+        return name == "scalar" ? &scalar : nullptr;
+    }
+
+    static std::atomic<const ByteSearchKernels *> &selected() {
+        static std::atomic<const ByteSearchKernels *> instance(detect());
+        return instance;
+    }
+
+    static const ByteSearchKernels *detect() {
+        for (const char *name : {"avx2", "sse2"})
+            if (auto kernels = byName(name))
+                return kernels;
+        return byName("scalar");
+    }
+
+    static const ByteSearchKernels &get() {
+        return *selected().load(std::memory_order_relaxed);
+    }
+};
+
+size_t ByteSearch::count(std::string_view str, const ByteSet &set) {
+    const auto *data = reinterpret_cast<const uint8_t *>(str.data());
+    if (str.size() < SCALAR_THRESHOLD)
+        return ByteSearchKernels::countScalar(data, str.size(), set);
+    return ByteSearchKernels::get().count(data, str.size(), set);
+}
+
+size_t ByteSearch::find(std::string_view str, std::string_view needle, size_t pos) {
+    // single bytes are left to memchr
+    if (pos > str.size() || needle.size() < 2 || str.size() - pos < SCALAR_THRESHOLD)
+        return str.find(needle, pos);
+
+    size_t size = str.size() - pos;
+    size_t found = ByteSearchKernels::get().find(str.data() + pos, size, needle.data(), needle.size());
+    return found < size ? pos + found : npos;
+}
+
+const char *ByteSearch::kernelName() {
+    return ByteSearchKernels::get().name;
+}
+
+bool ByteSearch::selectKernel(std::string_view name) {
+    auto kernels = ByteSearchKernels::byName(name);
+    if (!kernels)
+        return false;
+
+    ByteSearchKernels::selected().store(kernels, std::memory_order_relaxed);
+    return true;
+}
+
+size_t ByteSearch::searchVector(const uint8_t *data, size_t size, const ByteSet &set, bool negate) {
+    return ByteSearchKernels::get().search(data, size, set, negate);
+}
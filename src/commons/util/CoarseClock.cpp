@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/util/CoarseClock.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+    struct TickerState {
+        // serializes start and stop, including joining the thread
+        std::mutex control;
+        // guards stopped
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::thread thread;
+        size_t references = 0;
+        bool stopped = false;
+
+        ~TickerState() {
+            // ticker still referenced at exit
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                stopped = true;
+                cond.notify_all();
+            }
+
+            if (thread.joinable())
+                thread.join();
+        }
+    };
+
+    TickerState &tickerState() {
+        static TickerState instance;
+        return instance;
+    }
+}
+
+void CoarseClock::start(int64_t intervalMillis) {
+    auto &state = tickerState();
+    std::unique_lock<std::mutex> lock(state.control);
+
+    if (state.references++ > 0)
+        return;
+
+    // publish exact values before readers switch to the cache
+    update();
+    mTicking.store(true, std::memory_order_release);
+
+    state.stopped = false;
+    state.thread = std::thread(&CoarseClock::threadEntry, intervalMillis < 1 ? 1 : intervalMillis);
+}
+
+void CoarseClock::stop() {
+    auto &state = tickerState();
+    std::unique_lock<std::mutex> lock(state.control);
+    if (state.references == 0 || --state.references > 0)
+        return;
+
+    mTicking.store(false, std::memory_order_release);
+    {
+        std::unique_lock<std::mutex> stateLock(state.mutex);
+        state.stopped = true;
+        state.cond.notify_all();
+    }
+
+    if (state.thread.joinable())
+        state.thread.join();
+}
+
+void CoarseClock::threadEntry(int64_t intervalMillis) {
+    auto &state = tickerState();
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    while (!state.stopped) {
+        state.cond.wait_for(lock, std::chrono::milliseconds(intervalMillis));
+        update();
+    }
+}
+
+void CoarseClock::update() {
+    using namespace std::chrono;
+    mWallMillis.store(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count(),
+                      std::memory_order_relaxed);
+    mSteadyMillis.store(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count(),
+                        std::memory_order_relaxed);
+}
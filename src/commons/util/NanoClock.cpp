@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/util/NanoClock.h>
+
+#include <thread>
+
+#if COMMONS_NANOCLOCK_TSC
+    #include <cpuid.h>
+#endif
+
+namespace {
+#if COMMONS_NANOCLOCK_TSC
+    bool hasInvariantTsc() {
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+            return false;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return false;
+        return edx & (1u << 8);
+    }
+
+    // reads a pair of TSC and monotonic clock, taking the tightest of a few attempts
+    void readPair(uint64_t &ticks, int64_t &nanos) {
+        uint64_t bestWindow = UINT64_MAX;
+        for (int i = 0; i < 5; i++) {
+            uint64_t before = __rdtsc();
+            int64_t monotonic = NanoClock::monotonicNow();
+            uint64_t after = __rdtsc();
+
+            if (after - before < bestWindow) {
+                bestWindow = after - before;
+                ticks = before + (after - before) / 2;
+                nanos = monotonic;
+            }
+        }
+    }
+#endif
+}
+
+NanoClock::Calibration NanoClock::calibrate() {
+    Calibration result;
+#if COMMONS_NANOCLOCK_TSC
+    if (!hasInvariantTsc())
+        return result;
+
+    uint64_t startTicks = 0, endTicks = 0;
+    int64_t startNanos = 0, endNanos = 0;
+    readPair(startTicks, startNanos);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    readPair(endTicks, endNanos);
+
+    if (endTicks <= startTicks || endNanos <= startNanos)
+        return result;
+
+    result.frequency = static_cast<double>(endTicks - startTicks) * 1e9 / static_cast<double>(endNanos - startNanos);
+    result.mult = static_cast<int64_t>(1e9 / result.frequency * static_cast<double>(int64_t(1) << SHIFT));
+    result.baseTicks = endTicks;
+    result.baseNanos = endNanos;
+    result.useTsc = result.mult > 0;
+#endif
+    return result;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/util/Time.h>
+#include <commons/util/TimeFormat.h>
+
+std::string Time::formatIso8601() {
+    if (mIsUTC)
+        return TimeFormat::iso8601().format(mTimestamp);
+
+    // local time with UTC designator, as formatted before
+    static const TimeFormat localFormat("%Y-%m-%dT%H:%M:%S.%kZ", false);
+    return localFormat.format(mTimestamp);
+}
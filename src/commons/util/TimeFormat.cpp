@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/util/TimeFormat.h>
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+    // two digits of every number below 100
+    constexpr char DIGITS[] =
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+    // sign and digits of the largest year in the int64_t millisecond range, with some headroom
+    constexpr size_t MAX_YEAR_SIZE = 12;
+    constexpr int64_t MILLIS_PER_QUARTER_HOUR = 15 * 60 * 1000;
+
+    inline char *writeTwo(char *out, unsigned value) {
+        std::memcpy(out, DIGITS + value * 2, 2);
+        return out + 2;
+    }
+
+    inline int64_t floorDiv(int64_t value, int64_t divisor) {
+        int64_t quotient = value / divisor;
+        return quotient * divisor > value ? quotient - 1 : quotient;
+    }
+
+    // reads exactly count digits
+    inline bool readDigits(std::string_view &text, size_t count, unsigned &value) {
+        if (text.size() < count)
+            return false;
+
+        value = 0;
+        for (size_t i = 0; i < count; i++) {
+            unsigned digit = static_cast<unsigned>(text[i] - '0');
+            if (digit > 9)
+                return false;
+            value = value * 10 + digit;
+        }
+        text.remove_prefix(count);
+        return true;
+    }
+
+    inline bool readChar(std::string_view &text, char c) {
+        if (text.empty() || text.front() != c)
+            return false;
+        text.remove_prefix(1);
+        return true;
+    }
+
+    unsigned daysInMonth(int64_t year, unsigned month) {
+        static constexpr unsigned days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+        return month == 2 && leap ? 29 : days[month - 1];
+    }
+}
+
+TimeFormat::TimeFormat(std::string_view format, bool utc) : mUTC(utc) {
+    size_t literalStart = 0;
+    for (size_t i = 0; i < format.size(); i++) {
+        if (format[i] != '%')
+            continue;
+        if (i + 1 == format.size())
+            throw time_error("Incomplete specifier at end of format");
+
+        addLiteral(format.substr(literalStart, i - literalStart));
+        literalStart = i + 2;
+
+        switch (format[++i]) {
+            case 'Y': addField(Field::Year); break;
+            case 'm': addField(Field::Month); break;
+            case 'd': addField(Field::Day); break;
+            case 'H': addField(Field::Hour); break;
+            case 'M': addField(Field::Minute); break;
+            case 'S': addField(Field::Second); break;
+            case 'k': addField(Field::Millis); break;
+            case 'z': addField(Field::Offset); break;
+            case 'F':
+                addField(Field::Year);
+                addLiteral("-");
+                addField(Field::Month);
+                addLiteral("-");
+                addField(Field::Day);
+                break;
+            case 'T':
+                addField(Field::Hour);
+                addLiteral(":");
+                addField(Field::Minute);
+                addLiteral(":");
+                addField(Field::Second);
+                break;
+            case '%': addLiteral("%"); break;
+            default:
+                throw time_error(std::string("Unsupported format specifier %") + format[i]);
+        }
+    }
+    addLiteral(format.substr(std::min(literalStart, format.size())));
+}
+
+size_t TimeFormat::format(int64_t timestamp, char *buffer) const {
+    int64_t seconds = floorDiv(timestamp, 1000);
+    auto millis = static_cast<unsigned>(timestamp - seconds * 1000);
+    int32_t offset = mUTC ? 0 : utcOffsetSeconds(timestamp);
+
+    int64_t local = seconds + offset;
+    int64_t days = floorDiv(local, 86400);
+    auto secondOfDay = static_cast<unsigned>(local - days * 86400);
+
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    char *out = buffer;
+    for (const Part &part : mParts) {
+        switch (part.field) {
+            case Field::Literal:
+                std::memcpy(out, mLiterals.data() + part.offset, part.size);
+                out += part.size;
+                break;
+            case Field::Year:
+                if (year >= 0 && year <= 9999) {
+                    out = writeTwo(out, static_cast<unsigned>(year / 100));
+                    out = writeTwo(out, static_cast<unsigned>(year % 100));
+                } else
+                    out = std::to_chars(out, out + MAX_YEAR_SIZE, year).ptr;
+                break;
+            case Field::Month: out = writeTwo(out, month); break;
+            case Field::Day: out = writeTwo(out, day); break;
+            case Field::Hour: out = writeTwo(out, secondOfDay / 3600); break;
+            case Field::Minute: out = writeTwo(out, secondOfDay / 60 % 60); break;
+            case Field::Second: out = writeTwo(out, secondOfDay % 60); break;
+            case Field::Millis:
+                *out++ = static_cast<char>('0' + millis / 100);
+                out = writeTwo(out, millis % 100);
+                break;
+            case Field::Offset: {
+                *out++ = offset < 0 ? '-' : '+';
+                auto minutes = static_cast<unsigned>(offset < 0 ? -offset : offset) / 60;
+                out = writeTwo(out, minutes / 60);
+                out = writeTwo(out, minutes % 60);
+                break;
+            }
+        }
+    }
+    return static_cast<size_t>(out - buffer);
+}
+
+bool TimeFormat::tryParseIso8601(std::string_view text, int64_t &timestamp) {
+    unsigned year, month, day, hour, minute, second;
+    if (!readDigits(text, 4, year) || !readChar(text, '-') || !readDigits(text, 2, month) || !readChar(text, '-')
+            || !readDigits(text, 2, day))
+        return false;
+    if (text.empty() || (text.front() != 'T' && text.front() != 't' && text.front() != ' '))
+        return false;
+    text.remove_prefix(1);
+    if (!readDigits(text, 2, hour) || !readChar(text, ':') || !readDigits(text, 2, minute) || !readChar(text, ':')
+            || !readDigits(text, 2, second))
+        return false;
+
+    // leap second 60 is accepted and counted as the first second of the next minute
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59
+            || second > 60)
+        return false;
+
+    // fraction of any precision, truncated to milliseconds
+    unsigned millis = 0;
+    if (readChar(text, '.') || readChar(text, ',')) {
+        size_t digits = 0;
+        for (; digits < text.size() && text[digits] >= '0' && text[digits] <= '9'; digits++) {
+            if (digits < 3)
+                millis = millis * 10 + static_cast<unsigned>(text[digits] - '0');
+        }
+        if (digits == 0)
+            return false;
+        for (size_t i = digits; i < 3; i++)
+            millis *= 10;
+        text.remove_prefix(digits);
+    }
+
+    int32_t offset = 0;
+    if (!text.empty() && (text.front() == 'Z' || text.front() == 'z'))
+        text.remove_prefix(1);
+    else if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+        bool negative = text.front() == '-';
+        text.remove_prefix(1);
+
+        unsigned offsetHours, offsetMinutes = 0;
+        if (!readDigits(text, 2, offsetHours))
+            return false;
+        if (readChar(text, ':')) {
+            if (!readDigits(text, 2, offsetMinutes))
+                return false;
+        } else if (!text.empty() && !readDigits(text, 2, offsetMinutes))
+            return false;
+        if (offsetHours > 23 || offsetMinutes > 59)
+            return false;
+
+        offset = static_cast<int32_t>(offsetHours * 3600 + offsetMinutes * 60);
+        if (negative)
+            offset = -offset;
+    }
+    if (!text.empty())
+        return false;
+
+    int64_t seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    timestamp = seconds * 1000 + millis;
+    return true;
+}
+
+int32_t TimeFormat::utcOffsetSeconds(int64_t timestamp) {
+    struct Cache {
+        int64_t quarterHour = INT64_MIN;
+        int32_t offset = 0;
+    };
+    thread_local Cache cache;
+
+    int64_t quarterHour = floorDiv(timestamp, MILLIS_PER_QUARTER_HOUR);
+    if (quarterHour != cache.quarterHour) {
+        auto seconds = static_cast<time_t>(floorDiv(timestamp, 1000));
+        tm local {};
+        Time::localtime_safe(&seconds, &local);
+
+        int64_t localSeconds = daysFromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1),
+                                             static_cast<unsigned>(local.tm_mday)) * 86400
+                               + local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+        cache.offset = static_cast<int32_t>(localSeconds - seconds);
+        cache.quarterHour = quarterHour;
+    }
+    return cache.offset;
+}
+
+int64_t TimeFormat::daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+void TimeFormat::civilFromDays(int64_t days, int64_t &year, unsigned &month, unsigned &day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    auto dayOfEra = static_cast<unsigned>(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+void TimeFormat::addField(Field field) {
+    mParts.push_back({field, 0, 0});
+    switch (field) {
+        case Field::Year: mMaxSize += MAX_YEAR_SIZE; break;
+        case Field::Millis: mMaxSize += 3; break;
+        case Field::Offset: mMaxSize += 5; break;
+        default: mMaxSize += 2; break;
+    }
+}
+
+void TimeFormat::addLiteral(std::string_view text) {
+    if (text.empty())
+        return;
+
+    // merge adjacent literals
+    if (!mParts.empty() && mParts.back().field == Field::Literal)
+        mParts.back().size += static_cast<uint32_t>(text.size());
+    else
+        mParts.push_back({Field::Literal, static_cast<uint32_t>(mLiterals.size()), static_cast<uint32_t>(text.size())});
+
+    mLiterals.append(text);
+    mMaxSize += text.size();
+}
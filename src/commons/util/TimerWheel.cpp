@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/util/TimerWheel.h>
+
+#include <algorithm>
+
+namespace {
+    inline int64_t floorDiv(int64_t value, int64_t divisor) {
+        int64_t quotient = value / divisor;
+        return quotient * divisor > value ? quotient - 1 : quotient;
+    }
+}
+
+TimerWheel::TimerWheel(int64_t tickMillis, int64_t nowMillis)
+        : mTickMillis(std::max<int64_t>(tickMillis, 1)), mOriginMillis(nowMillis) {
+    uint32_t offset = 0;
+    for (int level = 0; level < LEVELS; level++) {
+        mLevelOffsets[level] = offset;
+        offset += levelSlots(level);
+    }
+    mSlots.assign(offset, NIL);
+}
+
+TimerWheel::Id TimerWheel::schedule(int64_t delayMillis, Callback_t callback, int64_t nowMillis) {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    uint32_t index = mFreeList;
+    if (index != NIL)
+        mFreeList = mNodes[index].next;
+    else {
+        index = static_cast<uint32_t>(mNodes.size());
+        mNodes.emplace_back();
+    }
+
+    // first tick at or after the due time, but never in the past
+    int64_t due = nowMillis + std::max<int64_t>(delayMillis, 0) - mOriginMillis;
+    Node &node = mNodes[index];
+    node.expiry = std::max(-floorDiv(-due, mTickMillis), mCurrentTick + 1);
+    node.callback = std::move(callback);
+
+    link(index);
+    mSize++;
+
+    if (mWakeup)
+        mWakeup();
+    return static_cast<Id>(node.generation) << 32 | index;
+}
+
+bool TimerWheel::setWakeup(Callback_t wakeup) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (wakeup && mWakeup)
+        return false;
+
+    mWakeup = std::move(wakeup);
+    return true;
+}
+
+bool TimerWheel::cancel(Id id) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (!find(id))
+        return false;
+
+    auto index = static_cast<uint32_t>(id);
+    unlink(index);
+    release(index);
+    return true;
+}
+
+bool TimerWheel::pending(Id id) const {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return find(id) != nullptr;
+}
+
+std::optional<int64_t> TimerWheel::leftMillis(Id id, int64_t nowMillis) const {
+    std::unique_lock<std::mutex> lock(mMutex);
+    const Node *node = find(id);
+    if (!node)
+        return std::nullopt;
+
+    return std::max<int64_t>(mOriginMillis + node->expiry * mTickMillis - nowMillis, 0);
+}
+
+size_t TimerWheel::advance(int64_t nowMillis) {
+    std::vector<Callback_t> expired;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        int64_t targetTick = floorDiv(nowMillis - mOriginMillis, mTickMillis);
+
+        while (mCurrentTick < targetTick) {
+            // nothing to cascade or expire
+            if (mSize == 0) {
+                mCurrentTick = targetTick;
+                break;
+            }
+            mCurrentTick++;
+
+            // move timeouts of the next slot of each higher level down, whenever the lower level wraps around
+            for (int level = 1; level < LEVELS; level++) {
+                if (mCurrentTick & ((int64_t(1) << levelShift(level)) - 1))
+                    break;
+                cascade(level);
+            }
+
+            uint32_t &head = mSlots[mCurrentTick & (levelSlots(0) - 1)];
+            while (head != NIL) {
+                uint32_t index = head;
+                unlink(index);
+                expired.push_back(std::move(mNodes[index].callback));
+                release(index);
+            }
+        }
+    }
+
+    // without lock, so that callbacks can use the wheel
+    for (auto &callback : expired) {
+        if (callback)
+            callback();
+    }
+    return expired.size();
+}
+
+std::optional<int64_t> TimerWheel::nextTimeoutMillis(int64_t nowMillis) const {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mSize == 0)
+        return std::nullopt;
+
+    // first level holds exact expiry ticks, the others are cascaded at the start of their slot, which may happen
+    // before timeouts of the first level expire
+    std::optional<int64_t> nextTick;
+    for (int level = 0; level < LEVELS; level++) {
+        int shift = levelShift(level);
+        uint32_t mask = levelSlots(level) - 1;
+        for (uint32_t i = level == 0 ? 1 : 0; i <= mask; i++) {
+            int64_t block = (mCurrentTick >> shift) + i;
+            if (mSlots[mLevelOffsets[level] + (block & mask)] != NIL) {
+                // cascade of the current block of a higher level already happened, its next one is a full turn away
+                int64_t tick = level == 0 || i > 0 ? block << shift : (block + mask + 1) << shift;
+                nextTick = std::min(nextTick.value_or(tick), tick);
+                break;
+            }
+        }
+    }
+    if (!nextTick)
+        return std::nullopt;
+
+    return std::max<int64_t>(mOriginMillis + *nextTick * mTickMillis - nowMillis, 0);
+}
+
+size_t TimerWheel::size() const {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mSize;
+}
+
+TimerWheel::Node *TimerWheel::find(Id id) {
+    auto index = static_cast<uint32_t>(id);
+    if (index >= mNodes.size())
+        return nullptr;
+
+    Node &node = mNodes[index];
+    if (node.slot == NIL || node.generation != static_cast<uint32_t>(id >> 32))
+        return nullptr;
+    return &node;
+}
+
+const TimerWheel::Node *TimerWheel::find(Id id) const {
+    return const_cast<TimerWheel *>(this)->find(id);
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node &node = mNodes[index];
+    int64_t delta = node.expiry - mCurrentTick;
+
+    // lowest level whose range covers the timeout, timeouts beyond all levels wait in the last one
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= int64_t(1) << (levelShift(level + 1)))
+        level++;
+    int64_t expiry = std::min(node.expiry, mCurrentTick + (int64_t(1) << (levelShift(LEVELS - 1) + LEVEL_BITS)) - 1);
+
+    uint32_t slot = mLevelOffsets[level] + ((expiry >> levelShift(level)) & (levelSlots(level) - 1));
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = mSlots[slot];
+    if (node.next != NIL)
+        mNodes[node.next].prev = index;
+    mSlots[slot] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node &node = mNodes[index];
+    if (node.prev != NIL)
+        mNodes[node.prev].next = node.next;
+    else
+        mSlots[node.slot] = node.next;
+    if (node.next != NIL)
+        mNodes[node.next].prev = node.prev;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node &node = mNodes[index];
+    node.callback = nullptr;
+    node.slot = NIL;
+    node.prev = NIL;
+    // skip generation 0, so that no id equals INVALID_ID
+    if (++node.generation == 0)
+        node.generation = 1;
+
+    node.next = mFreeList;
+    mFreeList = index;
+    mSize--;
+}
+
+void TimerWheel::cascade(int level) {
+    uint32_t slot = mLevelOffsets[level] + ((mCurrentTick >> levelShift(level)) & (levelSlots(level) - 1));
+
+    uint32_t index = mSlots[slot];
+    mSlots[slot] = NIL;
+    while (index != NIL) {
+        uint32_t next = mNodes[index].next;
+        link(index);
+        index = next;
+    }
+}
@@ -23,6 +23,7 @@
 #include "secure_memory/String.h"
 
 #include <network/Connection.h>
+#include <commons/log/LogRateLimit.h>
 
 // global one-time network init on a per-platform basis
 Native::Init gInit;
@@ -123,13 +124,13 @@ bool Connection::tryConnect() {
         return true;
     }
     catch (const resolve_error &e) {
-        Log::dbg << "Resolve error occurred: " << e.what();
+        L_dbg_limit(10, 1000) << "Resolve error occurred: " << e.what();
     }
     catch (const socket_error &e) {
-        Log::dbg << "Socket error occurred: " << e.what();
+        L_dbg_limit(10, 1000) << "Socket error occurred: " << e.what();
     }
     catch (const connection_error &e) {
-        Log::dbg << "Connection error occurred: " << e.what();
+        L_dbg_limit(10, 1000) << "Connection error occurred: " << e.what();
     }
     return false;
 }
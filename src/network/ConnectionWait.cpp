@@ -24,6 +24,8 @@
 #include "socket/NotifySocket.h"
 #include "socket/SocketWait.h"
 
+#include <limits>
+
 using ForeachSocket_cb = bool(uint32_t index, const Connection::Ref &connection, const TCPSocket *socket);
 /**
  * Iterate all Connection weak_ptr in specified list and either remove the pointer if it is expired,
@@ -55,6 +57,16 @@ static bool foreachSocket(std::vector<std::weak_ptr<Connection>> &connections,
 }
 
 bool ConnectionWait::wait(const NotifyCallback &notifyCallback, const ConnectionCallback_t &connectionCallback) {
+    return waitInternal(notifyCallback, connectionCallback, nullptr);
+}
+
+bool ConnectionWait::wait(const NotifyCallback &notifyCallback, const ConnectionCallback_t &connectionCallback,
+                          TimerWheel &timers) {
+    return waitInternal(notifyCallback, connectionCallback, &timers);
+}
+
+bool ConnectionWait::waitInternal(const NotifyCallback &notifyCallback, const ConnectionCallback_t &connectionCallback,
+                                  TimerWheel *timers) {
     // filter expired weak pointers out of connections
     foreachSocket(mConnections);
     // deep copy to avoid modifications of mConnections breaking the synchronization of entries and connections
@@ -81,18 +93,34 @@ bool ConnectionWait::wait(const NotifyCallback &notifyCallback, const Connection
         return true;
     });
 
-    // indefinite wait for one of sockets to become readable or a connection to succeed/fail
-    if (SocketWait::wait(entries) == NetworkResultType::SUCCESS) {
-        // clear and call notify cb if notify was set
+    // wait at most until the next timer is due, indefinitely without timers
+    std::optional<int32_t> timeoutMs;
+    if (timers) {
+        // timers scheduled from now on wake up the wait, so none are missed after computing the timeout
+        L_assert(timers->setWakeup([this] () { wakeup(); }), connection_wait_error);
+
+        if (auto next = timers->nextTimeoutMillis())
+            timeoutMs = static_cast<int32_t>(std::min<int64_t>(*next, std::numeric_limits<int32_t>::max()));
+    }
+
+    // wait for one of sockets to become readable or a connection to succeed/fail
+    auto rv = SocketWait::wait(entries, timeoutMs);
+    if (timers)
+        timers->setWakeup({});
+
+    bool success = false;
+    if (rv == NetworkResultType::SUCCESS) {
+        success = true;
+
+        // clear and call notify cb if notify was set, wakeups only interrupt the wait
         if (entries.at(0).readable()) {
             clearNotify();
 
-            if (!notifyCallback())
-                return false;
+            success = !mNotified.exchange(false) || notifyCallback();
         }
 
-        // call connection cb for each connection that has some response set
-        return foreachSocket(connections, [&] (uint32_t index, const Connection::Ref &connection, const TCPSocket *) {
+        // call connection cb for each connection that has some response set, unless the notify cb failed
+        success = success && foreachSocket(connections, [&] (uint32_t index, const Connection::Ref &connection, const TCPSocket *) {
             const auto &entry = entries.at(index + 1);
 
             if ((entry.except() && !connectionCallback(connection, State::Exception)) ||
@@ -103,11 +131,24 @@ bool ConnectionWait::wait(const NotifyCallback &notifyCallback, const Connection
             return true;
         });
     }
+    else if (timers && rv == NetworkTimeoutError())
+        // woke up for the next timer
+        success = true;
 
-    return false;
+    // run due timers, also after socket events, so busy connections cannot starve timeouts
+    if (timers)
+        timers->advance();
+
+    return success;
 }
 
 void ConnectionWait::notify() {
+    // set before the socket becomes readable, so the wait always sees it
+    mNotified.store(true);
+    wakeup();
+}
+
+void ConnectionWait::wakeup() {
     auto notify_sock = dynamic_cast<NotifySocket*>(mNotify.get());
     if (notify_sock)
         notify_sock->notify();
@@ -18,11 +18,11 @@
  */
 
 #include <network/component/ConnectionInfo.h>
-#include <network/component/Uri.h>
+#include <network/component/UriView.h>
 
 ConnectionInfo ConnectionInfo::parseConnectURI(const std::string &uriStr, uint16_t defaultPort) {
     // example: vd://net/?h=abc.com&p=1234&s=false
-    Uri uri(uriStr);
+    UriView uri(uriStr);
 
     // check scheme and host
     L_assert_eq("vd", uri.schema(), parse_error);
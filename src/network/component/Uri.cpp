@@ -18,33 +18,46 @@
  */
 
 #include <network/component/Uri.h>
+#include <network/component/UriView.h>
 #include <commons/util/Str.h>
+#include <commons/util/ByteSearch.h>
 
 #include <algorithm>
-#include <iomanip>
-#include <tuple>
-
-static std::tuple<std::string, std::string> splitTwo(const std::string &str, const std::string &delim) {
-    auto parts = Str::splitAll(str, delim, 2);
+#include <array>
+#include <cstring>
+
+// unreserved characters are never encoded
+static constexpr ByteSet UNRESERVED("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_.~");
+static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// per byte: value of the hex digit, or INVALID_HEX
+static constexpr uint8_t INVALID_HEX = 0xFF;
+static constexpr auto HEX_VALUES = [] () {
+    std::array<uint8_t, 256> result {};
+    for (auto &value : result)
+        value = INVALID_HEX;
+    for (int i = 0; i < 10; i++)
+        result['0' + i] = static_cast<uint8_t>(i);
+    for (int i = 0; i < 6; i++)
+        result['A' + i] = result['a' + i] = static_cast<uint8_t>(10 + i);
+    return result;
+}();
 
-    auto part0 = parts.size() > 0 ? parts[0] : "";
-    auto part1 = parts.size() > 1 ? parts[1] : "";
-    return { part0, part1 };
+// true if str has a "%" followed by two hex digits at pos
+static bool isEscape(std::string_view str, size_t pos) {
+    return pos + 2 < str.size() && HEX_VALUES[static_cast<uint8_t>(str[pos + 1])] != INVALID_HEX
+           && HEX_VALUES[static_cast<uint8_t>(str[pos + 2])] != INVALID_HEX;
 }
 
-static Uri::KeyValuePairList_t splitKeyValuePairs(const std::string &str) {
+static Uri::KeyValuePairList_t splitKeyValuePairs(std::string_view str) {
     Uri::KeyValuePairList_t result;
 
-    auto parts = Str::splitAll(str, "&");
-    for (const auto &part : parts) {
-        auto kvp = Str::splitAll(part, "=", 2);
-
-        auto kvp0 = kvp.size() > 0 ? Uri::decode(kvp[0]) : "";
-        auto kvp1 = kvp.size() > 1 ? Uri::decode(kvp[1]) : "";
-
+    UriView::forEachPair(str, [&result] (std::string_view key, std::string_view value) {
+        auto kvp0 = Uri::decode(key);
         if (!kvp0.empty())
-            result.emplace_back(kvp0, kvp1);
-    }
+            result.emplace_back(std::move(kvp0), Uri::decode(value));
+        return true;
+    });
 
     return result;
 }
@@ -70,35 +83,84 @@ static std::optional<std::string> findValueByKey(const Uri::KeyValuePairList_t &
     return {};
 }
 
-/*static*/ std::string Uri::encode(const std::string &str) {
-    static const std::string allowed = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_.~";
+/*static*/ std::string Uri::encode(std::string_view str) {
+    std::string result(encodedSize(str), '\0');
+    encode(str, result.data());
+    return result;
+}
 
-    std::stringstream bruce;
-    bruce << std::hex << std::setfill('0');
+/*static*/ size_t Uri::encode(std::string_view str, char *out) {
+    char *begin = out;
 
-    for (const auto &c : str) {
-        if (allowed.find(c) != std::string::npos)
-            bruce << c;
-        else
-            bruce << '%' << std::setw(2) << std::uppercase << int(c) << std::nouppercase;
+    // copy runs of unreserved characters at once, escape the rest
+    for (size_t pos = 0; pos < str.size(); ) {
+        size_t next = std::min(ByteSearch::findFirstNotOf(str, UNRESERVED, pos), str.size());
+        std::memcpy(out, str.data() + pos, next - pos);
+        out += next - pos;
+
+        if (next < str.size()) {
+            auto c = static_cast<uint8_t>(str[next]);
+            *out++ = '%';
+            *out++ = HEX_DIGITS[c >> 4];
+            *out++ = HEX_DIGITS[c & 0x0F];
+        }
+        pos = next + 1;
     }
 
-    return bruce.str();
+    return out - begin;
 }
 
-/*static*/ std::string Uri::decode(const std::string &str) {
-    std::stringstream bruce;
+/*static*/ size_t Uri::encodedSize(std::string_view str) {
+    // every escaped character takes two more
+    return str.size() + 2 * (str.size() - ByteSearch::count(str, UNRESERVED));
+}
 
-    for (size_t i = 0; i < str.size(); i++) {
-        if (str[i] == '%' && i + 3 <= str.size()) {
-            bruce << static_cast<char>(std::stoul(str.substr(i + 1, 2), nullptr, 16));
-            i += 2;
+/*static*/ std::string Uri::decode(std::string_view str) {
+    std::string result(decodedSize(str), '\0');
+    decode(str, result.data());
+    return result;
+}
+
+/*static*/ size_t Uri::decode(std::string_view str, char *out) {
+    char *begin = out;
+
+    for (size_t pos = 0; pos < str.size(); ) {
+        size_t next = std::min(str.find('%', pos), str.size());
+        std::memcpy(out, str.data() + pos, next - pos);
+        out += next - pos;
+
+        if (next == str.size())
+            break;
+
+        if (isEscape(str, next)) {
+            *out++ = static_cast<char>(HEX_VALUES[static_cast<uint8_t>(str[next + 1])] << 4
+                                       | HEX_VALUES[static_cast<uint8_t>(str[next + 2])]);
+            pos = next + 3;
+        }
+        else {
+            // invalid escape is kept
+            *out++ = '%';
+            pos = next + 1;
+        }
+    }
+
+    return out - begin;
+}
+
+/*static*/ size_t Uri::decodedSize(std::string_view str) {
+    size_t size = str.size();
+
+    // every valid escape takes two less
+    for (size_t next = str.find('%'); next != std::string_view::npos; ) {
+        if (isEscape(str, next)) {
+            size -= 2;
+            next = str.find('%', next + 3);
         }
         else
-            bruce << str[i];
+            next = str.find('%', next + 1);
     }
 
-    return bruce.str();
+    return size;
 }
 
 /*static*/ std::string Uri::pathCombine(const std::string &a, const std::string &b) {
@@ -113,18 +175,15 @@ static std::optional<std::string> findValueByKey(const Uri::KeyValuePairList_t &
 }
 
 Uri::Uri(const std::string &uri) {
-    auto [ schemaValue, schemaRemaining ] = splitTwo(uri, "://");
-    schema(schemaValue);
-
-    auto [ hostValue, hostRemaining ] = splitTwo(schemaRemaining, "/");
-    host(hostValue);
+    UriView view(uri);
+    mSchema = view.schema();
+    mHost = view.host();
 
-    auto [ pathValue, pathRemaining ] = splitTwo(hostRemaining, "?");
-    path(pathValue);
+    for (auto part : view.pathParts())
+        mPathParts.emplace_back(part);
 
-    auto [ queryValue, fragmentValue ] = splitTwo(pathRemaining, "#");
-    query(queryValue);
-    fragment(fragmentValue);
+    mQueryParts = splitKeyValuePairs(view.query());
+    mFragmentParts = splitKeyValuePairs(view.fragment());
 }
 
 std::string Uri::path() const {
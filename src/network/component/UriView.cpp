@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <network/component/UriView.h>
+#include <network/component/Uri.h>
+
+#include <tuple>
+
+UriView::UriView(std::string_view uri) {
+    std::string_view remaining;
+    std::tie(mSchema, remaining) = splitTwo(uri, "://");
+    std::tie(mHost, remaining) = splitTwo(remaining, "/");
+    std::tie(mPath, remaining) = splitTwo(remaining, "?");
+    std::tie(mQuery, mFragment) = splitTwo(remaining, "#");
+}
+
+std::pair<std::string_view, std::string_view> UriView::splitTwo(std::string_view str, std::string_view delim) {
+    std::string_view part0, part1;
+
+    auto parts = Str::tokenize(str, delim, 2);
+    auto it = parts.begin();
+    if (it != parts.end())
+        part0 = *it++;
+    if (it != parts.end())
+        part1 = *it;
+
+    return { part0, part1 };
+}
+
+std::optional<std::string> UriView::findValue(std::string_view pairs, std::string_view key) {
+    // pairs with empty keys are dropped by Uri
+    if (key.empty())
+        return {};
+
+    std::optional<std::string> result;
+    forEachPair(pairs, [&] (std::string_view rawKey, std::string_view rawValue) {
+        // keys without escapes are compared without decoding
+        bool match = rawKey.find('%') == std::string_view::npos ? rawKey == key : Uri::decode(rawKey) == key;
+        if (match)
+            result = Uri::decode(rawValue);
+        return !match;
+    });
+
+    return result;
+}
@@ -165,7 +165,7 @@ protected:
         }
 
         if (mVerifyLocation.empty())
-            Log::warn << "Default certificate path could not be found";
+            L_warn << "Default certificate path could not be found";
 
         OPENSSL_init_ssl(0, nullptr);
     }
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/thread/ConcurrentLruCache.h>
+#include "CacheTest.h"
+
+#include <thread>
+
+TEST_F(CacheTest, testBasic) {
+    ConcurrentLruCache<std::string, int> cache(100);
+
+    EXPECT_FALSE(cache.get("a"));
+    EXPECT_TRUE(cache.put("a", 1));
+    EXPECT_TRUE(cache.put("b", 2));
+    EXPECT_EQ(1, cache.get("a"));
+    EXPECT_EQ(2, cache.get("b"));
+
+    // replace
+    EXPECT_TRUE(cache.put("a", 3));
+    EXPECT_EQ(3, cache.get("a"));
+    EXPECT_EQ(2u, cache.size());
+
+    // erase
+    EXPECT_TRUE(cache.erase("a"));
+    EXPECT_FALSE(cache.erase("a"));
+    EXPECT_FALSE(cache.get("a"));
+    EXPECT_EQ(1u, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(3u, cache.hits());
+    EXPECT_EQ(2u, cache.misses());
+}
+
+TEST_F(CacheTest, testEviction) {
+    // single shard to make eviction order deterministic
+    ConcurrentLruCache<int, int> cache(4, 0, 1);
+    for (int i = 0; i < 4; i++)
+        cache.put(i, i);
+
+    // reference all but 2, which is the first candidate for eviction
+    cache.get(0);
+    cache.get(1);
+    cache.get(3);
+
+    cache.put(4, 4);
+    EXPECT_EQ(4u, cache.size());
+    EXPECT_EQ(1u, cache.evictions());
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_EQ(4, cache.get(4));
+
+    // bound holds for many inserts
+    for (int i = 5; i < 100; i++)
+        cache.put(i, i);
+    EXPECT_EQ(4u, cache.size());
+    EXPECT_EQ(96u, cache.evictions());
+}
+
+TEST_F(CacheTest, testEvictionAllReferenced) {
+    ConcurrentLruCache<int, int> cache(2, 0, 1);
+    cache.put(0, 0);
+    cache.put(1, 1);
+    cache.get(0);
+    cache.get(1);
+
+    // the new entry is never the one evicted to make room for itself
+    EXPECT_TRUE(cache.put(2, 2));
+    EXPECT_EQ(2, cache.get(2));
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ(1u, cache.evictions());
+}
+
+TEST_F(CacheTest, testWeight) {
+    ConcurrentLruCache<int, std::string> cache(10, 0, 1, [] (const int &, const std::string &value) {
+        return value.size();
+    });
+
+    EXPECT_TRUE(cache.put(1, "aaaa"));
+    EXPECT_TRUE(cache.put(2, "bbbb"));
+    EXPECT_EQ(8u, cache.weight());
+
+    // exceeds capacity: one of the others is evicted
+    EXPECT_TRUE(cache.put(3, "cccc"));
+    EXPECT_EQ(8u, cache.weight());
+    EXPECT_EQ(2u, cache.size());
+
+    // growing entry evicts others, never itself
+    cache.get(1);
+    cache.get(3);
+    EXPECT_TRUE(cache.put(3, "cccccccc"));
+    EXPECT_EQ("cccccccc", cache.get(3));
+    EXPECT_EQ(1u, cache.size());
+
+    // never fits
+    EXPECT_FALSE(cache.put(4, "ddddddddddd"));
+    EXPECT_FALSE(cache.get(4));
+}
+
+TEST_F(CacheTest, testTtl) {
+    using namespace std::chrono_literals;
+    ConcurrentLruCache<int, int> cache(10, 50);
+
+    cache.put(1, 1);
+    cache.put(2, 2, 0);
+    EXPECT_EQ(1, cache.get(1));
+
+    std::this_thread::sleep_for(100ms);
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_EQ(2, cache.get(2));
+}
+
+TEST_F(CacheTest, testThreading) {
+    ConcurrentLruCache<int, int> cache(1000);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, t] () {
+            for (int i = 0; i < 10000; i++) {
+                int key = (i * 7 + t) % 2000;
+                if (auto value = cache.get(key))
+                    ASSERT_EQ(key, *value);
+                else
+                    cache.put(key, key);
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_LE(cache.size(), 1000u + cache.shardCount());
+    EXPECT_EQ(40000u, cache.hits() + cache.misses());
+}
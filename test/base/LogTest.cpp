@@ -17,10 +17,34 @@
  * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <commons/log/BinaryLog.h>
 #include <commons/log/Log.h>
+#include <commons/log/LogContext.h>
+#include <commons/log/LogRateLimit.h>
+#include <commons/log/LogTag.h>
+#include <commons/log/impl/FlightRecorderLogger.h>
+#include <commons/log/impl/JournaldLogger.h>
+#include <commons/log/impl/RotatingFileLogger.h>
 #include <commons/log/impl/StdoutLogger.h>
 #include "LogTest.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <thread>
+
+#ifndef WIN32
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+COMMONS_LOG_TAG(network);
+COMMONS_LOG_TAG(storage);
+
 TEST_F(LogTest, Simple) {
     Log::dbg<<"Test 123 "<<456<<" "<<true;
     Log::err<<"This is an error "<<std::hex<<1337<<" "<<0.0559897f;
@@ -97,3 +121,655 @@ TEST_F(LogTest, DefaultLogger) {
 
     Log::dbg << "Test test 123";
 }
+
+TEST_F(LogTest, CompiledLevels) {
+    // tests are built with all levels compiled in
+    EXPECT_TRUE(Log::isCompiled(LogLevel::LEVEL_TRACE));
+    EXPECT_TRUE(Log::isCompiled(LogLevel::LEVEL_ERROR));
+
+    Log::get().enableLogLevel(LogLevel::LEVEL_DEBUG);
+    int evaluated = 0;
+    L_dbg << "Test " << ++evaluated;
+    EXPECT_EQ(1, evaluated);
+    EXPECT_EQ("[LogLevel::LEVEL_DEBUG] Test 1\n", mLogger->toString(LogLevel::LEVEL_DEBUG));
+
+    // statement macros must not capture a following else
+    bool elseTaken = false;
+    if (evaluated == 0)
+        L_err << "unreachable";
+    else
+        elseTaken = true;
+    EXPECT_TRUE(elseTaken);
+}
+
+TEST_F(LogTest, LazyEvaluation) {
+    int evaluated = 0;
+    auto expensive = [&evaluated] () {
+        return ++evaluated;
+    };
+
+    Log::get().setLogLevel(LogLevel::LEVEL_INFO);
+    EXPECT_FALSE(Log::get().isLevelEnabled(LogLevel::LEVEL_DEBUG));
+    EXPECT_TRUE(Log::get().isLevelEnabled(LogLevel::LEVEL_INFO));
+    L_trac << "Test " << expensive();
+    L_dbg << "Test " << expensive();
+    EXPECT_EQ(0, evaluated);
+    EXPECT_EQ("", mLogger->toString(LogLevel::LEVEL_DEBUG));
+
+    // global disable has priority
+    Log::get().setEnabled(false);
+    EXPECT_FALSE(Log::get().isLevelEnabled(LogLevel::LEVEL_ERROR));
+    L_err << "Test " << expensive();
+    EXPECT_EQ(0, evaluated);
+
+    Log::get().setLogLevel(LogLevel::LEVEL_TRACE);
+    L_dbg << "Test " << expensive();
+    EXPECT_EQ(1, evaluated);
+    EXPECT_EQ("[LogLevel::LEVEL_DEBUG] Test 1\n", mLogger->toString(LogLevel::LEVEL_DEBUG));
+}
+
+TEST_F(LogTest, FanOut) {
+    // logger writing into a preallocated buffer
+    class CountingLogger : public ILogger {
+    public:
+        void write(std::string_view record, LogLevel) override {
+            bytes += record.size();
+        }
+        std::ostream &stream() override {
+            return std::cout;
+        }
+
+        size_t bytes = 0;
+    } loggers[3];
+
+    Log::get().unregisterLogger(mLogger);
+    for (auto &logger : loggers)
+        Log::get().registerLogger(&logger);
+    Log::get().setLogLevel(LogLevel::LEVEL_TRACE);
+
+    // records are formatted once and reach every logger, allocations are measured by commons_bench
+    for (int i = 0; i < 1000; i++)
+        Log::info << "Record " << i << " value " << 1.5 << " " << 'x';
+
+    for (auto &logger : loggers) {
+        EXPECT_GT(logger.bytes, 1000u * 20);
+        Log::get().unregisterLogger(&logger);
+    }
+    Log::get().registerLogger(mLogger);
+}
+
+TEST_F(LogTest, RateLimit) {
+    Log::get().enableLogLevel(LogLevel::LEVEL_DEBUG);
+    int evaluated = 0;
+    auto logStorm = [&evaluated] (int count) {
+        for (int i = 0; i < count; i++)
+            L_dbg_limit(3, 300) << "Failure " << ++evaluated;
+    };
+    // limits of the call sites are static, wait for their burst to refill if the test is repeated
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+    // first burst passes, the rest is neither formatted nor written
+    logStorm(10);
+    EXPECT_EQ(3, evaluated);
+    EXPECT_EQ("[LogLevel::LEVEL_DEBUG] Failure 1\n[LogLevel::LEVEL_DEBUG] Failure 2\n"
+              "[LogLevel::LEVEL_DEBUG] Failure 3\n", mLogger->toString(LogLevel::LEVEL_DEBUG));
+
+    // call sites are limited independently
+    L_dbg_limit(1, 300) << "Other";
+    EXPECT_NE(std::string::npos, mLogger->toString(LogLevel::LEVEL_DEBUG).find("Other"));
+
+    // suppressed count is reported with the next record passing
+    LogRateLimit limit(1, 20);
+    EXPECT_TRUE(limit.allow());
+    EXPECT_FALSE(limit.allow());
+    EXPECT_FALSE(limit.allow());
+    EXPECT_EQ(2u, limit.suppressed());
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_TRUE(limit.allow());
+
+    std::stringstream bruce;
+    bruce << limit.takeSuppressed() << "next";
+    EXPECT_EQ("(2 similar messages suppressed) next", bruce.str());
+    bruce.str("");
+    bruce << limit.takeSuppressed() << "next";
+    EXPECT_EQ("next", bruce.str());
+}
+
+TEST_F(LogTest, CollapseRepeats) {
+    Log::get().enableLogLevel(LogLevel::LEVEL_DEBUG);
+    Log::get().setCollapseRepeats(true);
+
+    for (int i = 0; i < 5; i++)
+        Log::dbg << "Same";
+    Log::dbg << "Different";
+    for (int i = 0; i < 3; i++)
+        Log::dbg << "Different";
+    Log::get().flush();
+
+    // single repeat is written as is
+    Log::dbg << "Different";
+    Log::get().setCollapseRepeats(false);
+
+    EXPECT_EQ("[LogLevel::LEVEL_DEBUG] Same\n"
+              "[LogLevel::LEVEL_DEBUG] Last message repeated 4 times\n"
+              "[LogLevel::LEVEL_DEBUG] Different\n"
+              "[LogLevel::LEVEL_DEBUG] Last message repeated 3 times\n"
+              "[LogLevel::LEVEL_DEBUG] Different\n", mLogger->toString(LogLevel::LEVEL_DEBUG));
+}
+
+TEST_F(LogTest, Tags) {
+    Log::get().setLogLevel(LogLevel::LEVEL_INFO);
+    auto &tags = LogTagTable::get();
+
+    // tags follow the global levels by default
+    L_dbg_tag(network) << "hidden";
+    L_err_tag(storage) << "Disk full";
+    EXPECT_EQ("", mLogger->toString(LogLevel::LEVEL_DEBUG));
+    EXPECT_EQ("[LogLevel::LEVEL_ERROR] [storage] Disk full\n", mLogger->toString(LogLevel::LEVEL_ERROR));
+
+    // raising one tag leaves the others and untagged statements alone
+    tags.setLevel("network", LogLevel::LEVEL_TRACE);
+    L_dbg_tag(network) << "Connected";
+    L_dbg_tag(storage) << "hidden";
+    L_dbg << "hidden";
+    EXPECT_EQ("[LogLevel::LEVEL_DEBUG] [network] Connected\n", mLogger->toString(LogLevel::LEVEL_DEBUG));
+
+    // lowering a tag below the global levels
+    tags.setLevel("storage", LogLevel::VALUE_INVALID);
+    L_err_tag(storage) << "hidden";
+    EXPECT_EQ("[LogLevel::LEVEL_ERROR] [storage] Disk full\n", mLogger->toString(LogLevel::LEVEL_ERROR));
+
+    // global disable applies to configured tags
+    Log::get().setEnabled(false);
+    EXPECT_FALSE(LogTagTable::isEnabled<LogTag_network>(LogLevel::LEVEL_ERROR));
+    Log::get().setEnabled(true);
+    EXPECT_TRUE(LogTagTable::isEnabled<LogTag_network>(LogLevel::LEVEL_TRACE));
+
+    // configured before first use, and reset
+    tags.setLevel("later", LogLevel::LEVEL_ERROR);
+    EXPECT_EQ(3u, tags.tags().size());
+    tags.resetAll();
+    EXPECT_FALSE(LogTagTable::isEnabled<LogTag_network>(LogLevel::LEVEL_TRACE));
+    EXPECT_TRUE(LogTagTable::isEnabled<LogTag_storage>(LogLevel::LEVEL_INFO));
+
+    Log::get().setLogLevel(LogLevel::LEVEL_TRACE);
+    EXPECT_TRUE(LogTagTable::isEnabled<LogTag_network>(LogLevel::LEVEL_TRACE));
+}
+
+TEST_F(LogTest, Context) {
+    Log::get().enableLogLevel(LogLevel::LEVEL_DEBUG);
+
+    // captures the structured context
+    class ContextLogger : public ILogger {
+    public:
+        std::ostream &stream() override {
+            return bruce;
+        }
+        void writeWithContext(std::string_view record, LogLevel, const LogRecordContext &context) override {
+            messages.emplace_back(record.substr(context.prefixSize));
+            std::string encoded;
+            LogContext::forEachField(context.fields, [&encoded] (std::string_view key, std::string_view value) {
+                encoded.append(key).append(":").append(value).append(";");
+            });
+            fields.push_back(encoded);
+        }
+
+        std::stringstream bruce;
+        std::vector<std::string> messages;
+        std::vector<std::string> fields;
+    } contextLogger;
+    Log::get().registerLogger(&contextLogger);
+
+    Log::dbg << "none";
+    {
+        LogContext::Scope request("request", 42);
+        Log::dbg << "one";
+        {
+            LogContext::Scope connection("conn", "db-1");
+            Log::dbg << "two";
+        }
+        Log::dbg << "one again";
+    }
+    Log::dbg << "none again";
+
+    EXPECT_EQ("[LogLevel::LEVEL_DEBUG] none\n[LogLevel::LEVEL_DEBUG] [request=42] one\n"
+              "[LogLevel::LEVEL_DEBUG] [request=42 conn=db-1] two\n[LogLevel::LEVEL_DEBUG] [request=42] one again\n"
+              "[LogLevel::LEVEL_DEBUG] none again\n", mLogger->toString(LogLevel::LEVEL_DEBUG));
+
+    std::vector<std::string> messages = {"none", "one", "two", "one again", "none again"};
+    std::vector<std::string> fields = {"", "request:42;", "request:42;conn:db-1;", "request:42;", ""};
+    EXPECT_EQ(messages, contextLogger.messages);
+    EXPECT_EQ(fields, contextLogger.fields);
+
+    // context of the logging thread is kept in async mode
+    contextLogger.fields.clear();
+    Log::get().enableAsync();
+    std::thread([] () {
+        LogContext::Scope request("request", 7);
+        Log::dbg << "async";
+    }).join();
+    Log::dbg << "main";
+    Log::get().disableAsync();
+    EXPECT_EQ(std::vector<std::string>({"request:7;", ""}), contextLogger.fields);
+
+    Log::get().unregisterLogger(&contextLogger);
+}
+
+TEST_F(LogTest, Async) {
+    Log::get().enableLogLevel(LogLevel::LEVEL_DEBUG);
+    Log::get().enableAsync();
+    EXPECT_TRUE(Log::get().isAsync());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t] () {
+            for (int i = 0; i < 100; i++)
+                Log::dbg << "Thread " << t << " record " << i;
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    Log::get().flush();
+    std::string text = mLogger->toString(LogLevel::LEVEL_DEBUG);
+    EXPECT_EQ(400, std::count(text.begin(), text.end(), '\n'));
+    EXPECT_NE(std::string::npos, text.find("[LogLevel::LEVEL_DEBUG] Thread 3 record 99\n"));
+
+    // back to synchronous logging
+    Log::get().disableAsync();
+    EXPECT_FALSE(Log::get().isAsync());
+    mLogger->clear();
+    Log::err << "sync";
+    EXPECT_EQ("[LogLevel::LEVEL_ERROR] sync\n", mLogger->toString(LogLevel::LEVEL_ERROR));
+}
+
+TEST_F(LogTest, AsyncDrop) {
+    // logger stalling the worker until the gate is released
+    class GateLogger : public ILogger {
+    public:
+        bool wantsLog(LogLevel) override {
+            std::unique_lock<std::mutex> lock(gate);
+            return true;
+        }
+        std::ostream &stream() override {
+            return bruce;
+        }
+
+        std::mutex gate;
+        std::stringstream bruce;
+    } gateLogger;
+
+    Log::get().registerLogger(&gateLogger);
+    Log::get().enableAsync(1, Log::AsyncFullPolicy::Drop);
+    uint64_t dropped = Log::get().droppedRecords();
+
+    gateLogger.gate.lock();
+    Log::err << "first";
+    // the first record occupies the only slot until the worker wrote it
+    Log::err << "second";
+    EXPECT_EQ(dropped + 1, Log::get().droppedRecords());
+    gateLogger.gate.unlock();
+
+    Log::get().disableAsync();
+    EXPECT_EQ("first\n", gateLogger.bruce.str());
+    EXPECT_EQ("[LogLevel::LEVEL_ERROR] first\n", mLogger->toString(LogLevel::LEVEL_ERROR));
+    Log::get().unregisterLogger(&gateLogger);
+}
+
+TEST_F(LogTest, Binary) {
+    const char *filename = "binary.log";
+    std::remove(filename);
+    Log::get().setLogLevel(LogLevel::LEVEL_INFO);
+
+    for (int session = 0; session < 2; session++) {
+        BinaryLogger logger(filename, 64);
+        for (int i = 0; i < 10; i++)
+            L_bin(logger, LEVEL_INFO, "Record {} of {}: {} {}", i, std::string("session"), 1.5, true);
+        L_bin(logger, LEVEL_WARNING, "No arguments");
+        L_bin(logger, LEVEL_WARNING, "Surplus", 'x', -7ll, 42u);
+        // disabled at runtime
+        L_bin(logger, LEVEL_DEBUG, "Debug {}", 1);
+    }
+
+    std::ifstream in(filename, std::ios_base::binary);
+    std::stringstream out;
+    EXPECT_TRUE(BinaryLogDecoder::decode(in, out));
+
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(out, line); )
+        lines.push_back(line);
+    ASSERT_EQ(24u, lines.size());
+
+    auto text = [] (const std::string &line) {
+        return line.substr(line.find(" [") + 1);
+    };
+    EXPECT_EQ("[LogLevel::LEVEL_INFO] Record 0 of session: 1.5 1", text(lines[0]));
+    EXPECT_EQ("[LogLevel::LEVEL_INFO] Record 9 of session: 1.5 1", text(lines[9]));
+    EXPECT_EQ("[LogLevel::LEVEL_WARNING] No arguments", text(lines[10]));
+    EXPECT_EQ("[LogLevel::LEVEL_WARNING] Surplus x -7 42", text(lines[11]));
+    EXPECT_EQ("[LogLevel::LEVEL_INFO] Record 0 of session: 1.5 1", text(lines[12]));
+
+    // truncated file decodes complete records only
+    in.clear();
+    in.seekg(0);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::stringstream truncated(data.substr(0, data.size() - 3)), partial;
+    EXPECT_FALSE(BinaryLogDecoder::decode(truncated, partial));
+    EXPECT_NE(std::string::npos, partial.str().find("Record 9"));
+
+    in.close();
+    std::remove(filename);
+}
+
+TEST_F(LogTest, BinaryThreads) {
+    const char *filename = "binary_threads.log";
+    std::remove(filename);
+    Log::get().setLogLevel(LogLevel::LEVEL_INFO);
+
+    constexpr int threadCount = 4, recordCount = 2000;
+    {
+        BinaryLogger logger(filename, 256);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++)
+            threads.emplace_back([&logger, t] () {
+                for (int i = 0; i < recordCount; i++)
+                    L_bin(logger, LEVEL_INFO, "Thread {} record {}", t, i);
+            });
+
+        // flushing concurrently writes complete records only
+        for (int i = 0; i < 10; i++)
+            logger.flush();
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    std::ifstream in(filename, std::ios_base::binary);
+    std::stringstream out;
+    EXPECT_TRUE(BinaryLogDecoder::decode(in, out));
+
+    // records of every thread are complete and in order
+    std::vector<int> next(threadCount, 0);
+    int lines = 0;
+    for (std::string line; std::getline(out, line); lines++) {
+        int t, i;
+        ASSERT_EQ(2, std::sscanf(line.substr(line.find("Thread")).c_str(), "Thread %d record %d", &t, &i));
+        ASSERT_TRUE(t >= 0 && t < threadCount);
+        EXPECT_EQ(next[t]++, i);
+    }
+    EXPECT_EQ(threadCount * recordCount, lines);
+
+    in.close();
+    std::remove(filename);
+}
+
+TEST_F(LogTest, RotatingFile) {
+    const std::string filename = "rotating.log";
+    auto fileSize = [] (const std::string &name) -> long {
+        std::ifstream file(name, std::ios_base::binary | std::ios_base::ate);
+        return file ? static_cast<long>(file.tellg()) : -1;
+    };
+    auto removeAll = [&filename] () {
+        std::remove(filename.c_str());
+        for (const char *suffix : {".1", ".2", ".3", ".1.gz", ".2.gz", ".3.gz"})
+            std::remove((filename + suffix).c_str());
+    };
+    removeAll();
+
+    RotatingFileLogger::Config config;
+    config.maxBytes = 2000;
+    config.keepFiles = 2;
+    config.bufferBytes = 64 * 1024;
+    config.flushIntervalMillis = 0;
+    config.compress = true;
+    {
+        RotatingFileLogger logger(filename, config);
+        ASSERT_TRUE(logger.isOpen());
+
+        // buffered until flushed
+        logger.write("first", LogLevel::LEVEL_INFO);
+        EXPECT_EQ(0, fileSize(filename));
+        logger.flush();
+        EXPECT_LT(0, fileSize(filename));
+
+        // each record is about 50 bytes, so this rotates several times
+        std::string record(20, 'x');
+        for (int i = 0; i < 200; i++)
+            logger.write(record, LogLevel::LEVEL_INFO);
+    }
+
+    EXPECT_LT(0, fileSize(filename));
+    EXPECT_LE(fileSize(filename), 2000);
+    // compressed if supported
+    std::string suffix = RotatingFileLogger::compressionSupported() ? ".gz" : "";
+    EXPECT_LT(0, fileSize(filename + ".1" + suffix));
+    EXPECT_LT(0, fileSize(filename + ".2" + suffix));
+    EXPECT_EQ(-1, fileSize(filename + ".3" + suffix));
+    removeAll();
+}
+
+#ifndef WIN32
+TEST_F(LogTest, RotatingFileReopen) {
+    const std::string dir = "rotating.dir", filename = dir + "/rotating.log";
+    auto readFile = [] (const std::string &name) {
+        std::ifstream file(name, std::ios_base::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    auto removeAll = [&] () {
+        for (const char *suffix : {"", ".1"})
+            std::remove((filename + suffix).c_str());
+        rmdir(dir.c_str());
+        rmdir((dir + ".away").c_str());
+    };
+    removeAll();
+    ASSERT_EQ(0, mkdir(dir.c_str(), 0755));
+
+    RotatingFileLogger::Config config;
+    config.maxBytes = 0;
+    config.keepFiles = 1;
+    config.flushIntervalMillis = 0;
+    config.reopenIntervalMillis = 100;
+    {
+        RotatingFileLogger logger(filename, config);
+        ASSERT_TRUE(logger.isOpen());
+        logger.write("before", LogLevel::LEVEL_INFO);
+
+        // reopening fails while the directory is gone, records are dropped
+        ASSERT_EQ(0, std::rename(dir.c_str(), (dir + ".away").c_str()));
+        logger.rotate();
+        EXPECT_FALSE(logger.isOpen());
+        logger.write("lost", LogLevel::LEVEL_INFO);
+        logger.write("lost", LogLevel::LEVEL_INFO);
+
+        // retried on a later write
+        ASSERT_EQ(0, std::rename((dir + ".away").c_str(), dir.c_str()));
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        logger.write("after", LogLevel::LEVEL_INFO);
+        EXPECT_TRUE(logger.isOpen());
+        logger.flush();
+
+        std::string data = readFile(filename);
+        EXPECT_NE(std::string::npos, data.find("before"));
+        EXPECT_NE(std::string::npos, data.find("Dropped 2 records"));
+        EXPECT_NE(std::string::npos, data.find("after"));
+        EXPECT_EQ(std::string::npos, data.find("lost"));
+    }
+    removeAll();
+}
+
+TEST_F(LogTest, FlightRecorder) {
+    const char *filename = "flight.rec";
+    std::remove(filename);
+
+    auto readLines = [filename] (size_t maxRecords) {
+        std::stringstream out;
+        EXPECT_TRUE(FlightRecorderReader::read(filename, out, maxRecords));
+
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(out, line); )
+            lines.push_back(line.substr(line.find(" [") + 1));
+        return lines;
+    };
+
+    {
+        FlightRecorderLogger logger(filename, 4096);
+        ASSERT_TRUE(logger.isOpen());
+        logger.write("first", LogLevel::LEVEL_TRACE);
+        logger.write("", LogLevel::LEVEL_DEBUG);
+
+        // readable while the process still runs, without flush or close
+        auto lines = readLines(0);
+        ASSERT_EQ(2u, lines.size());
+        EXPECT_EQ("[LogLevel::LEVEL_TRACE] first", lines[0]);
+        EXPECT_EQ("[LogLevel::LEVEL_DEBUG] ", lines[1]);
+    }
+
+    {
+        // reopening keeps previous records
+        FlightRecorderLogger logger(filename, 4096);
+        logger.write("second run", LogLevel::LEVEL_INFO);
+    }
+    EXPECT_EQ(3u, readLines(0).size());
+
+    {
+        // concurrent writers, without wrapping around
+        FlightRecorderLogger logger(filename, 64 * 1024);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&logger, t] () {
+                for (int i = 0; i < 100; i++)
+                    logger.write("Thread " + std::to_string(t) + " record " + std::to_string(i), LogLevel::LEVEL_INFO);
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+    EXPECT_EQ(400u, readLines(0).size());
+
+    {
+        // wrapping around several times keeps the most recent records
+        FlightRecorderLogger logger(filename, 4096);
+        for (int i = 0; i < 1000; i++)
+            logger.write("Record " + std::to_string(i), LogLevel::LEVEL_INFO);
+        logger.write("last", LogLevel::LEVEL_ERROR);
+    }
+
+    auto lines = readLines(0);
+    EXPECT_GT(lines.size(), 50u);
+    EXPECT_EQ("[LogLevel::LEVEL_ERROR] last", lines.back());
+    EXPECT_EQ("[LogLevel::LEVEL_INFO] Record 999", lines[lines.size() - 2]);
+
+    lines = readLines(3);
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ("[LogLevel::LEVEL_INFO] Record 998", lines[0]);
+
+    std::remove(filename);
+}
+#endif
+
+#ifndef WIN32
+TEST_F(LogTest, Journald) {
+    // local datagram socket standing in for journald
+    const char *path = "journal.sock";
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path);
+    ASSERT_EQ(0, bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+
+    timeval timeout {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // parses both field forms
+    auto receive = [fd] () {
+        std::map<std::string, std::string> fields;
+        char buffer[4096];
+        ssize_t size = recv(fd, buffer, sizeof(buffer), 0);
+        EXPECT_GT(size, 0);
+
+        std::string_view entry(buffer, size > 0 ? static_cast<size_t>(size) : 0);
+        while (!entry.empty()) {
+            size_t end = entry.find_first_of("=\n");
+            std::string name(entry.substr(0, end));
+            if (entry[end] == '=') {
+                size_t newline = entry.find('\n', end);
+                fields[name] = std::string(entry.substr(end + 1, newline - end - 1));
+                entry.remove_prefix(newline + 1);
+            } else {
+                uint64_t length = 0;
+                for (int i = 0; i < 8; i++)
+                    length |= static_cast<uint64_t>(static_cast<uint8_t>(entry[end + 1 + i])) << (i * 8);
+                fields[name] = std::string(entry.substr(end + 9, length));
+                entry.remove_prefix(end + 9 + length + 1);
+            }
+        }
+        return fields;
+    };
+
+    JournaldLogger::Config config;
+    config.socketPath = path;
+    config.identifier = "commons-test";
+    config.maxBatch = 4;
+    config.flushIntervalMillis = 0;
+
+    {
+        JournaldLogger logger(config);
+        ASSERT_TRUE(logger.isOpen());
+
+        logger.write("first", LogLevel::LEVEL_WARNING);
+        logger.write("multi\nline", LogLevel::LEVEL_DEBUG);
+
+        // batched until flush
+        char byte;
+        EXPECT_EQ(-1, recv(fd, &byte, 1, MSG_DONTWAIT));
+        logger.flush();
+
+        auto fields = receive();
+        EXPECT_EQ("4", fields["PRIORITY"]);
+        EXPECT_EQ("first", fields["MESSAGE"]);
+        EXPECT_EQ(0u, fields.count("REQUEST_ID"));
+        EXPECT_EQ("commons-test", fields["SYSLOG_IDENTIFIER"]);
+        EXPECT_FALSE(fields["TID"].empty());
+
+        fields = receive();
+        EXPECT_EQ("7", fields["PRIORITY"]);
+        EXPECT_EQ("multi\nline", fields["MESSAGE"]);
+
+        // full batch is sent without flush
+        for (int i = 0; i < 4; i++)
+            logger.write("Record " + std::to_string(i), LogLevel::LEVEL_ERROR);
+        for (int i = 0; i < 4; i++)
+            EXPECT_EQ("Record " + std::to_string(i), receive()["MESSAGE"]);
+
+        // context entries become fields
+        std::string_view contextFields("request-id\0" "5\0", 13);
+        logger.writeWithContext("[request-id=5] ctx", LogLevel::LEVEL_INFO, {15, contextFields});
+        logger.flush();
+        fields = receive();
+        EXPECT_EQ("ctx", fields["MESSAGE"]);
+        EXPECT_EQ("5", fields["REQUEST_ID"]);
+
+        // remaining entries are sent on close
+        logger.write("last", LogLevel::LEVEL_INFO);
+    }
+    EXPECT_EQ("last", receive()["MESSAGE"]);
+
+    // periodic flush
+    config.flushIntervalMillis = 10;
+    {
+        JournaldLogger logger(config);
+        logger.write("periodic", LogLevel::LEVEL_INFO);
+        EXPECT_EQ("periodic", receive()["MESSAGE"]);
+        EXPECT_EQ(0u, logger.failedEntries());
+    }
+
+    close(fd);
+    unlink(path);
+
+    // no journald
+    JournaldLogger missing(config);
+    EXPECT_FALSE(missing.isOpen());
+}
+#endif
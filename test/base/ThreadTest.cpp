@@ -19,6 +19,8 @@
 #include <commons/thread/impl/LockFreeQueue.h>
 #include <commons/thread/impl/LockingQueue.h>
 #include <commons/thread/IQueueWorker.h>
+#include <commons/thread/ThreadPool.h>
+#include <commons/thread/WorkerWatchdog.h>
 #include "ThreadTest.h"
 
 #define TEST_ITER 100
@@ -117,4 +119,116 @@ protected: \
     MAKE_WORKER_TEST(testAdvancedWorker, impl)
 
 MAKE_IMPL_TESTS(Locking);
-MAKE_IMPL_TESTS(LockFree);
\ No newline at end of file
+MAKE_IMPL_TESTS(LockFree);
+
+TEST_F(ThreadTest, testParallelFor) {
+    ThreadPool pool(4);
+    std::vector<int> values(10000, 0);
+
+    pool.parallelFor(0, values.size(), 64, [&values] (size_t i) {
+        values[i] += static_cast<int>(i);
+    });
+    for (size_t i = 0; i < values.size(); i++)
+        ASSERT_EQ(static_cast<int>(i), values[i]) << i;
+
+    // empty and single-chunk ranges run on the calling thread
+    auto caller = std::this_thread::get_id();
+    pool.parallelFor(5, 5, 1, [] (size_t) { FAIL(); });
+    pool.parallelFor(0, 10, 10, [caller] (size_t) { EXPECT_EQ(caller, std::this_thread::get_id()); });
+
+    // exceptions are rethrown on the calling thread
+    EXPECT_THROW(pool.parallelFor(0, 1000, 1, [] (size_t i) {
+        if (i == 500)
+            throw std::runtime_error("test");
+    }), std::runtime_error);
+}
+
+TEST_F(ThreadTest, testParallelReduce) {
+    ThreadPool pool(4);
+
+    auto sum = pool.parallelReduce(1, 100001, 100, uint64_t(0),
+            [] (uint64_t acc, size_t i) { return acc + i; },
+            [] (uint64_t a, uint64_t b) { return a + b; });
+    EXPECT_EQ(5000050000u, sum);
+
+    // chunk results are combined in order
+    auto str = pool.parallelReduce(0, 26, 3, std::string(),
+            [] (std::string acc, size_t i) { return acc + static_cast<char>('a' + i); },
+            [] (std::string a, const std::string &b) { return a + b; });
+    EXPECT_EQ("abcdefghijklmnopqrstuvwxyz", str);
+
+    // without workers everything runs inline
+    ThreadPool inlinePool(0);
+    EXPECT_EQ(45, inlinePool.parallelReduce(0, 10, 1, 0,
+            [] (int acc, size_t i) { return acc + static_cast<int>(i); },
+            [] (int a, int b) { return a + b; }));
+}
+
+class StallTestWorker : public IQueueWorker<TestMessage> {
+public:
+    explicit StallTestWorker(std::string name) : IQueueWorker(new LockingQueue<TestMessage>(), std::move(name)) { }
+    ~StallTestWorker() override {
+        stopThread();
+    }
+
+protected:
+    void doWork(const TestMessage &value) override {
+        using namespace std::chrono;
+        auto until = steady_clock::now() + milliseconds(300);
+
+        // testVal 1: spin to simulate busy worker, otherwise sleep to simulate blocked worker
+        if (value.testVal == 1)
+            while (steady_clock::now() < until);
+        else
+            std::this_thread::sleep_until(until);
+    }
+};
+
+TEST_F(ThreadTest, testWatchdog) {
+    using namespace std::chrono_literals;
+    std::vector<WorkerWatchdog::Report> reports;
+    WorkerWatchdog watchdog(100, 1000, [&reports] (const WorkerWatchdog::Report &report) {
+        reports.push_back(report);
+    });
+
+    StallTestWorker busy("busy"), blocked("blocked");
+    busy.startThread();
+    blocked.startThread();
+#ifndef WIN32
+    // cpu clocks become available once the threads are running
+    while (busy.cpuTimeNanos() < 0 || blocked.cpuTimeNanos() < 0)
+        std::this_thread::yield();
+#endif
+    watchdog.watch(&busy);
+    watchdog.watch(&blocked);
+
+    // nothing running yet
+    watchdog.check();
+    EXPECT_TRUE(reports.empty());
+
+    busy.enqueue(TestMessage{1});
+    blocked.enqueue(TestMessage{0});
+    blocked.enqueue(TestMessage{0});
+    std::this_thread::sleep_for(200ms);
+
+    // both stalled, but reported only once
+    watchdog.check();
+    watchdog.check();
+    ASSERT_EQ(2u, reports.size());
+
+    EXPECT_EQ("busy", reports[0].name);
+    EXPECT_GE(reports[0].busyMillis, 100);
+    EXPECT_EQ(0u, reports[0].queueDepth);
+    EXPECT_EQ("blocked", reports[1].name);
+    EXPECT_EQ(1u, reports[1].queueDepth);
+#ifndef WIN32
+    // absolute shares depend on the load of the machine, only the blocked worker is reliably idle
+    EXPECT_GT(reports[0].cpuUsage, reports[1].cpuUsage);
+    EXPECT_LT(reports[1].cpuUsage, 0.1);
+    EXPECT_GT(reports[0].cpuTimeNanos, reports[1].cpuTimeNanos);
+#endif
+
+    busy.stopThread();
+    blocked.stopThread();
+    EXPECT_EQ(1u, busy.workCount());
+}
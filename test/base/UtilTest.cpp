@@ -20,7 +20,17 @@
 #include "UtilTest.h"
 
 #include <commons/util/Str.h>
+#include <commons/util/ByteSearch.h>
 #include <commons/util/Time.h>
+#include <commons/util/RateLimiter.h>
+#include <commons/util/NanoTimer.h>
+#include <commons/util/TimeFormat.h>
+#include <commons/util/TimestampCache.h>
+#include <commons/util/TimerWheel.h>
+
+#include <random>
+#include <set>
+#include <thread>
 
 template<typename T>
 void assertHelperVectorEq(const std::vector<T> &va, const std::vector<T> &vb) {
@@ -44,6 +54,110 @@ TEST_F(UtilTest, testStrSplit) {
     ASSERT_VECTOR_EQ({"::e:"}, Str::splitAll("::e:", ":", 1));
 }
 
+TEST_F(UtilTest, testStrTokenize) {
+    auto collect = [] (const Str::Tokenizer &range) {
+        return std::vector<std::string>(range.begin(), range.end());
+    };
+
+    ASSERT_VECTOR_EQ({}, collect(Str::tokenize("Hello World", "")));
+    ASSERT_VECTOR_EQ({""}, collect(Str::tokenize("", ":")));
+    ASSERT_VECTOR_EQ({}, collect(Str::tokenize("", ":", 0, false)));
+    ASSERT_VECTOR_EQ({"Hello", "World"}, collect(Str::tokenize("Hello World", " ")));
+    ASSERT_VECTOR_EQ({"", "", "e", ""}, collect(Str::tokenize("::e:", ":")));
+    ASSERT_VECTOR_EQ({"", "", "e:"}, collect(Str::tokenize("::e:", ":", 3)));
+    ASSERT_VECTOR_EQ({"e"}, collect(Str::tokenize("::e:", ":", 0, false)));
+    ASSERT_VECTOR_EQ({"a", "b"}, collect(Str::tokenize("a//b//", "//", 0, false)));
+
+    // parts point into the source string
+    std::string str = "key=value";
+    auto range = Str::tokenize(str, "=");
+    auto it = range.begin();
+    EXPECT_EQ(str.data(), it->data());
+    EXPECT_EQ(str.data() + 4, (++it)->data());
+    EXPECT_TRUE(++it == range.end());
+
+    // same parts as the previous splitAll implementation
+    auto reference = [] (const std::string &str, const std::string &delim, size_t maxParts, bool allowEmpty) {
+        std::vector<std::string> result;
+        size_t next, last = 0, count = 0;
+        while ((next = str.find(delim, last)) != std::string::npos && (maxParts == 0 || count + 1 < maxParts)) {
+            if (allowEmpty || last < next)
+                result.emplace_back(str.substr(last, next - last));
+            last = next + delim.size();
+            count++;
+        }
+        if (allowEmpty || last < str.size())
+            result.emplace_back(str.substr(last));
+        return result;
+    };
+
+    std::mt19937 random(7);
+    for (int i = 0; i < 2000; i++) {
+        std::string input;
+        for (size_t j = random() % 12; j > 0; j--)
+            input += "ab:"[random() % 3];
+        std::string delim = i % 2 ? ":" : "a:";
+        size_t maxParts = random() % 4;
+        bool allowEmpty = random() % 2;
+
+        ASSERT_VECTOR_EQ(reference(input, delim, maxParts, allowEmpty),
+                         collect(Str::tokenize(input, delim, maxParts, allowEmpty)));
+        ASSERT_VECTOR_EQ(reference(input, delim, maxParts, allowEmpty),
+                         Str::splitAll(input, delim, maxParts, allowEmpty));
+    }
+}
+
+TEST_F(UtilTest, testByteSearch) {
+    const std::string defaultKernel = ByteSearch::kernelName();
+    EXPECT_FALSE(ByteSearch::selectKernel("unknown"));
+
+    // delimiters, unreserved URI characters, a set with too many ranges for SSE2 and high bytes
+    std::vector<ByteSet> sets = {
+            ByteSet("&="),
+            ByteSet("-_.~") | ByteSet::range('0', '9') | ByteSet::range('A', 'Z') | ByteSet::range('a', 'z'),
+            ByteSet("acegikmoqsuwy02468"),
+            ~ByteSet::range('\0', '\x7f'),
+            ByteSet(),
+    };
+    EXPECT_TRUE(sets[1].contains('q'));
+    EXPECT_FALSE(sets[1].contains('%'));
+    EXPECT_TRUE(sets[3].contains(0xC3));
+
+    std::mt19937 random(11);
+    for (const char *kernel : {"scalar", "sse2", "avx2"}) {
+        if (!ByteSearch::selectKernel(kernel))
+            continue;
+        EXPECT_EQ(std::string(kernel), ByteSearch::kernelName());
+
+        for (int i = 0; i < 3000; i++) {
+            std::string str;
+            for (size_t j = random() % 100; j > 0; j--)
+                str += i % 2 ? "ab&=x%\xc3"[random() % 7] : static_cast<char>(random());
+            const auto &set = sets[i % sets.size()];
+            size_t pos = random() % 8;
+
+            size_t firstOf = std::string::npos, firstNotOf = std::string::npos, count = 0;
+            for (size_t j = 0; j < str.size(); j++) {
+                bool contained = set.contains(static_cast<uint8_t>(str[j]));
+                count += contained;
+                if (j >= pos && contained && firstOf == std::string::npos)
+                    firstOf = j;
+                if (j >= pos && !contained && firstNotOf == std::string::npos)
+                    firstNotOf = j;
+            }
+
+            ASSERT_EQ(firstOf, ByteSearch::findFirstOf(str, set, pos)) << kernel << " " << i;
+            ASSERT_EQ(firstNotOf, ByteSearch::findFirstNotOf(str, set, pos)) << kernel << " " << i;
+            ASSERT_EQ(count, ByteSearch::count(str, set)) << kernel << " " << i;
+
+            for (std::string needle : {"&", "a&", "x%a", "ab&=x", "=x%a&b"})
+                ASSERT_EQ(str.find(needle, pos), ByteSearch::find(str, needle, pos)) << kernel << " " << i;
+        }
+    }
+
+    EXPECT_TRUE(ByteSearch::selectKernel(defaultKernel));
+}
+
 TEST_F(UtilTest, testStrJoin) {
     ASSERT_EQ("Hello World", Str::joinAll({"Hello", "World"}, " "));
     ASSERT_EQ("Hello World", Str::joinAll({"H", "llo World"}, "e"));
@@ -52,6 +166,13 @@ TEST_F(UtilTest, testStrJoin) {
     ASSERT_EQ("::e:", Str::joinAll({"", "", "e:"}, ":"));
     ASSERT_EQ("::e:", Str::joinAll({"", ":e:"}, ":"));
     ASSERT_EQ("::e:", Str::joinAll({"::e:"}, ":"));
+    ASSERT_EQ("", Str::joinAll({}, ":"));
+
+    // any range of string-like parts
+    std::vector<std::string_view> views = {"a", "bc", "", "d"};
+    ASSERT_EQ("a, bc, , d", Str::joinAll(views.begin(), views.end(), ", "));
+    auto parts = Str::tokenize("x::y", ":");
+    ASSERT_EQ("x--y", Str::joinAll(parts.begin(), parts.end(), "-"));
 }
 
 TEST_F(UtilTest, testTime) {
@@ -62,3 +183,316 @@ TEST_F(UtilTest, testTime) {
     EXPECT_EQ("6 02.03.2018 21:55:13.001", Time(1517694913001).formatFull("%w %m.%d.%Y %H:%M:%S.%k"));
     EXPECT_EQ("6 02.03.2018 21:55:13.001+0000", Time(1517694913001).formatFull("%w %m.%d.%Y %H:%M:%S.%k%z"));
 }
+
+TEST_F(UtilTest, testTimeFormat) {
+    TimeFormat iso("%FT%T.%kZ"), custom("%d.%m.%Y %H:%M:%S %%k %z"), local("%Y-%m-%dT%H:%M:%S.%k%z", false);
+    EXPECT_EQ("2018-02-03T21:55:13.160Z", iso.format(1517694913160));
+    EXPECT_EQ("03.02.2018 21:55:13 %k +0000", custom.format(1517694913160));
+    EXPECT_EQ("1969-12-31T23:59:59.999Z", iso.format(-1));
+    EXPECT_EQ("0000-03-01T00:00:00.000Z", iso.format(-62162035200000));
+    EXPECT_THROW(TimeFormat("%w"), time_error);
+
+    // matches the std::put_time based formatting, which supports no timestamps before 1970
+    for (int64_t ts = 123; ts < 86400000LL * 365 * 200; ts += 86400000LL * 7 + 3600123) {
+        ASSERT_EQ(Time(ts).formatFull("%Y-%m-%dT%H:%M:%S.%kZ"), TimeFormat::iso8601().format(ts));
+        ASSERT_EQ(Time(ts, false).formatFull("%Y-%m-%dT%H:%M:%S.%k%z"), local.format(ts));
+    }
+
+    // caller buffer
+    std::vector<char> buffer(iso.maxSize());
+    EXPECT_EQ(24u, iso.format(1517694913160, buffer.data()));
+    EXPECT_EQ("2018-02-03T21:55:13.160Z", std::string(buffer.data(), 24));
+
+    // parsing round trip
+    for (int64_t ts = -86400000LL * 800; ts < 86400000LL * 365 * 200; ts += 86400000LL * 7 + 3600123)
+        ASSERT_EQ(ts, TimeFormat::parseIso8601(TimeFormat::iso8601().format(ts)));
+
+    int64_t ts = 0;
+    EXPECT_TRUE(TimeFormat::tryParseIso8601("2018-02-03T21:55:13Z", ts));
+    EXPECT_EQ(1517694913000, ts);
+    EXPECT_TRUE(TimeFormat::tryParseIso8601("2018-02-03 23:55:13.16+02:00", ts));
+    EXPECT_EQ(1517694913160, ts);
+    EXPECT_TRUE(TimeFormat::tryParseIso8601("2018-02-03T16:25:13.160999-0530", ts));
+    EXPECT_EQ(1517694913160, ts);
+    EXPECT_TRUE(TimeFormat::tryParseIso8601("2018-02-03T21:55:13", ts));
+    EXPECT_EQ(1517694913000, ts);
+    EXPECT_TRUE(TimeFormat::tryParseIso8601("2016-12-31T23:59:60Z", ts));
+    EXPECT_EQ(1483228800000, ts);
+
+    for (const char *invalid : {"", "2018-02-03", "2018-02-30T00:00:00Z", "2018-13-01T00:00:00Z",
+                                "2018-02-03T24:00:00Z", "2018-02-03T21:55:13.Z", "2018-02-03T21:55:13+1",
+                                "2018-02-03T21:55:13Zx", "2018-2-03T21:55:13Z"}) {
+        ts = 42;
+        EXPECT_FALSE(TimeFormat::tryParseIso8601(invalid, ts)) << invalid;
+        EXPECT_EQ(42, ts);
+    }
+    EXPECT_THROW(TimeFormat::parseIso8601("invalid"), time_error);
+}
+
+TEST_F(UtilTest, testNanoClock) {
+    // monotonic
+    int64_t previous = NanoClock::now();
+    for (int i = 0; i < 100000; i++) {
+        int64_t now = NanoClock::now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+    if (NanoClock::usesTsc()) {
+        EXPECT_GT(NanoClock::tscFrequency(), 1e8);
+    }
+
+    // agrees with the system clock, pairs are read like the calibration does to exclude preemption between reads
+    auto readPair = [] (int64_t &clock, int64_t &system) {
+        int64_t bestWindow = INT64_MAX;
+        for (int i = 0; i < 5; i++) {
+            int64_t before = NanoClock::now(), monotonic = NanoClock::monotonicNow(), after = NanoClock::now();
+            if (after - before < bestWindow) {
+                bestWindow = after - before;
+                clock = before + (after - before) / 2;
+                system = monotonic;
+            }
+        }
+    };
+    int64_t clockStart, systemStart, clockEnd, systemEnd;
+    readPair(clockStart, systemStart);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    readPair(clockEnd, systemEnd);
+    int64_t clockElapsed = clockEnd - clockStart, systemElapsed = systemEnd - systemStart;
+    EXPECT_NEAR(static_cast<double>(systemElapsed), static_cast<double>(clockElapsed), systemElapsed * 0.005);
+    EXPECT_NEAR(static_cast<double>(NanoClock::monotonicNow()), static_cast<double>(NanoClock::now()), 1e7);
+
+    NanoTimer timer;
+    EXPECT_FALSE(timer.active());
+    EXPECT_EQ(0, timer.runningNanos());
+
+    timer.start(20000000);
+    EXPECT_TRUE(timer.running());
+    EXPECT_GT(timer.leftNanos(), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_TRUE(timer.elapsed());
+    EXPECT_GE(timer.runningNanos(), 30000000);
+    EXPECT_GE(timer.runningMillis(), 30);
+    EXPECT_EQ(0, timer.leftNanos());
+
+    timer.reset();
+    EXPECT_FALSE(timer.active());
+    EXPECT_FALSE(timer.elapsed());
+}
+
+TEST_F(UtilTest, testCoarseClock) {
+    // kernel coarse clocks lag by at most a few ticks
+    EXPECT_NEAR(Time::now(), Time::nowCoarse(), 50);
+    EXPECT_NEAR(Timer::steadyNow(), Timer::steadyNowCoarse(), 50);
+    EXPECT_LE(Timer::steadyNowCoarse(), Timer::steadyNow());
+    EXPECT_FALSE(CoarseClock::ticking());
+
+    // nested start/stop
+    CoarseClock::start();
+    CoarseClock::start();
+    EXPECT_TRUE(CoarseClock::ticking());
+    CoarseClock::stop();
+    EXPECT_TRUE(CoarseClock::ticking());
+
+    int64_t steadyStart = Timer::steadyNowCoarse(), wallStart = CoarseClock::logNow();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_GE(Timer::steadyNowCoarse() - steadyStart, 40);
+    EXPECT_GE(CoarseClock::logNow() - wallStart, 40);
+    EXPECT_NEAR(Time::now(), Time::nowCoarse(), 50);
+    EXPECT_LE(Timer::steadyNowCoarse(), Timer::steadyNow());
+
+    CoarseClock::stop();
+    EXPECT_FALSE(CoarseClock::ticking());
+    // unbalanced stop is ignored
+    CoarseClock::stop();
+
+    // restart after stop
+    CoarseClock::start(5);
+    EXPECT_TRUE(CoarseClock::ticking());
+    CoarseClock::stop();
+}
+
+TEST_F(UtilTest, testTimerWheel) {
+    TimerWheel wheel(10, 0);
+    std::vector<int> fired;
+
+    // spans all levels
+    auto a = wheel.schedule(5, [&fired] () { fired.push_back(1); }, 0);
+    wheel.schedule(3000, [&fired] () { fired.push_back(2); }, 0);
+    wheel.schedule(200000, [&fired] () { fired.push_back(3); }, 0);
+    auto d = wheel.schedule(200000, [&fired] () { fired.push_back(4); }, 0);
+    wheel.schedule(50000000, [&fired] () { fired.push_back(5); }, 0);
+    EXPECT_EQ(5u, wheel.size());
+    EXPECT_TRUE(wheel.pending(a));
+    EXPECT_EQ(3000, wheel.leftMillis(d, 197000));
+    EXPECT_EQ(10, wheel.nextTimeoutMillis(0));
+
+    EXPECT_EQ(0u, wheel.advance(9));
+    EXPECT_EQ(1u, wheel.advance(10));
+    EXPECT_FALSE(wheel.pending(a));
+    EXPECT_FALSE(wheel.cancel(a));
+
+    EXPECT_TRUE(wheel.cancel(d));
+    EXPECT_FALSE(wheel.leftMillis(d));
+    EXPECT_EQ(0u, wheel.advance(2990));
+    EXPECT_EQ(1u, wheel.advance(3000));
+    EXPECT_EQ(1u, wheel.advance(200000));
+    EXPECT_EQ(0u, wheel.advance(49999990));
+    EXPECT_EQ(1u, wheel.advance(50000000));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 5}), fired);
+    EXPECT_EQ(0u, wheel.size());
+    EXPECT_FALSE(wheel.nextTimeoutMillis(50000000));
+
+    // callbacks may reschedule
+    int repeats = 0;
+    std::function<void()> repeat = [&] () {
+        if (++repeats < 3)
+            wheel.schedule(100, repeat, 50000000 + repeats * 100);
+    };
+    wheel.schedule(100, repeat, 50000000);
+    for (int i = 1; i <= 5; i++)
+        wheel.advance(50000000 + i * 100);
+    EXPECT_EQ(3, repeats);
+}
+
+TEST_F(UtilTest, testTimerWheelRandom) {
+    TimerWheel wheel(1, 0);
+    std::mt19937 random(42);
+    std::vector<int64_t> due(20000), firedAt(20000, -1);
+    std::vector<TimerWheel::Id> ids(20000);
+    std::multiset<int64_t> pending;
+
+    int64_t now = 0;
+    for (size_t i = 0; i < due.size(); i++) {
+        // mostly near, some far away
+        int64_t delay = i % 10 == 0 ? random() % 100000000 : random() % 20000;
+        due[i] = delay;
+        ids[i] = wheel.schedule(delay, [&, i] () {
+            firedAt[i] = now;
+            pending.erase(pending.find(due[i]));
+        }, 0);
+    }
+    for (size_t i = 0; i < due.size(); i++) {
+        if (i % 3 == 0)
+            EXPECT_TRUE(wheel.cancel(ids[i]));
+        else
+            pending.insert(due[i]);
+    }
+
+    while (wheel.size() > 0) {
+        // never sleeps past the next timeout
+        int64_t wait = wheel.nextTimeoutMillis(now).value();
+        ASSERT_LE(now + wait, *pending.begin());
+
+        now += std::min<int64_t>(wait, static_cast<int64_t>(random() % 5000));
+        wheel.advance(now);
+    }
+    EXPECT_TRUE(pending.empty());
+
+    for (size_t i = 0; i < due.size(); i++)
+        ASSERT_EQ(i % 3 == 0 ? -1 : due[i], firedAt[i]) << i;
+}
+
+TEST_F(UtilTest, testWheelTimer) {
+    TimerWheel wheel(1);
+    int calls = 0;
+    WheelTimer timer(wheel, [&calls] () { calls++; });
+    EXPECT_FALSE(timer.running());
+    EXPECT_FALSE(timer.elapsed());
+
+    timer.start(20);
+    EXPECT_TRUE(timer.running());
+    EXPECT_EQ(20, timer.durationMillis());
+    EXPECT_GT(timer.leftMillis(), 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    wheel.advance();
+    EXPECT_TRUE(timer.elapsed());
+    EXPECT_EQ(0, timer.leftMillis());
+    EXPECT_EQ(1, calls);
+
+    // restarting cancels, reset and destruction cancel
+    timer.start(1000);
+    timer.start(1000);
+    EXPECT_EQ(1u, wheel.size());
+    timer.reset();
+    EXPECT_EQ(0u, wheel.size());
+    {
+        WheelTimer other(wheel, [] () { });
+        other.start(1000);
+        EXPECT_EQ(1u, wheel.size());
+    }
+    EXPECT_EQ(0u, wheel.size());
+}
+
+TEST_F(UtilTest, testTimestampCache) {
+    TimestampCache utc("%Y-%m-%dT%H:%M:%S.%kZ %%k", true), local("%Y-%m-%dT%H:%M:%S%z");
+
+    // same second, next second and backwards
+    for (int64_t ts : {1535465696000ll, 1535465696007ll, 1535465696999ll, 1535465697042ll, 1535465696500ll, 0ll}) {
+        EXPECT_EQ(Time(ts).formatFull("%Y-%m-%dT%H:%M:%S.%kZ %%k"), utc.format(ts));
+        EXPECT_EQ(Time(ts, false).formatFull("%Y-%m-%dT%H:%M:%S%z"), local.format(ts));
+    }
+    EXPECT_EQ("2018-08-28T14:14:56.123Z %k", utc.format(1535465696123ll));
+}
+
+TEST_F(UtilTest, testRateLimiter) {
+    RateLimiter limiter(10, 5);
+
+    // full bucket allows a burst
+    EXPECT_FALSE(limiter.tryAcquire(6));
+    EXPECT_TRUE(limiter.tryAcquire(3));
+    EXPECT_TRUE(limiter.tryAcquire(2));
+    EXPECT_FALSE(limiter.tryAcquire());
+
+    // one token every 100ms
+    Timer timer(Timer::begin::now);
+    EXPECT_FALSE(limiter.acquire(1, 50));
+    EXPECT_TRUE(limiter.acquire(2, 500));
+    EXPECT_GE(timer.runningMillis(), 150);
+
+    limiter.reset();
+    EXPECT_TRUE(limiter.tryAcquire(5));
+}
+
+TEST_F(UtilTest, testRateLimiterHighRate) {
+    // refill is not quantized to milliseconds
+    RateLimiter limiter(100000, 1);
+
+    int granted = 0;
+    Timer timer(Timer::begin::now, 200);
+    while (!timer.elapsed())
+        granted += limiter.tryAcquire();
+
+    EXPECT_GT(granted, 5000);
+    EXPECT_LE(granted, 20000 + 1000);
+}
+
+TEST_F(UtilTest, testRateLimiterThreading) {
+    RateLimiter limiter(1, 100);
+    std::atomic<int> acquired(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&] () {
+            for (int i = 0; i < 1000; i++)
+                if (limiter.tryAcquire())
+                    acquired++;
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    // refill within the test is at most a few tokens
+    EXPECT_GE(acquired.load(), 100);
+    EXPECT_LE(acquired.load(), 105);
+}
+
+TEST_F(UtilTest, testShardedRateLimiter) {
+    ShardedRateLimiter<std::string> limiter(1, 2, 1024);
+
+    EXPECT_TRUE(limiter.tryAcquire("a", 2));
+    EXPECT_FALSE(limiter.tryAcquire("a"));
+    EXPECT_TRUE(limiter.tryAcquire("b", 2));
+
+    limiter.reset();
+    EXPECT_TRUE(limiter.tryAcquire("a", 2));
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <network/component/ConnectionInfo.h>
+#include <commons/thread/ConcurrentLruCache.h>
+#include "ConnectionInfoTest.h"
+
+TEST_F(ConnectionInfoTest, testParseConnectURI) {
+    auto info = ConnectionInfo::parseConnectURI("vd://net/?h=abc.com&p=1234&s=false", 42);
+    EXPECT_EQ("abc.com", info.host());
+    EXPECT_EQ(1234, info.port());
+    EXPECT_FALSE(info.ssl());
+
+    info = ConnectionInfo::parseConnectURI("vd://net/?h=abc.com", 42);
+    EXPECT_EQ(42, info.port());
+    EXPECT_TRUE(info.ssl());
+
+    EXPECT_THROW(ConnectionInfo::parseConnectURI("vd://net/?p=1234", 42), parse_error);
+    EXPECT_THROW(ConnectionInfo::parseConnectURI("http://net/?h=abc.com", 42), parse_error);
+}
+
+TEST_F(ConnectionInfoTest, testCacheKey) {
+    ConcurrentLruCache<ConnectionInfo, std::string> cache(16);
+
+    cache.put(ConnectionInfo("abc.com", 1234), "first");
+    cache.put(ConnectionInfo("abc.com", 1235), "second");
+
+    // equality only considers host and port
+    EXPECT_EQ("first", cache.get(ConnectionInfo("abc.com", 1234, false)));
+    EXPECT_EQ("second", cache.get(ConnectionInfo("abc.com", 1235)));
+    EXPECT_FALSE(cache.get(ConnectionInfo("abc.org", 1234)));
+}
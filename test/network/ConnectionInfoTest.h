@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2023 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMMONS_CONNECTIONINFOTEST_H
+#define COMMONS_CONNECTIONINFOTEST_H
+
+#include <gtest/gtest.h>
+
+class ConnectionInfoTest : public ::testing::Test {
+
+};
+
+#endif //COMMONS_CONNECTIONINFOTEST_H
@@ -25,6 +25,8 @@
 #endif
 
 #include <network/ConnectionWait.h>
+#include <commons/util/Timer.h>
+#include <commons/util/TimerWheel.h>
 #include <secure_memory/String.h>
 
 #include <thread>
@@ -461,4 +463,71 @@ TEST_F(ConnectionTest, connectionWaitRealSSL) {
 
     EXPECT_TRUE(conn->connected());
     EXPECT_TRUE(conn->info().ssl());
-}
\ No newline at end of file
+}
+
+TEST_F(ConnectionTest, connectionWaitTimers) {
+    // switch to real native calls
+    mockReal();
+
+    ConnectionWait connectionWait;
+    TimerWheel timers(1);
+    bool notify = false, connections = false;
+    auto notifyCallback = [&] () { return (notify = true); };
+    auto connectionCallback = [&] (const Connection::Ref &, ConnectionWait::State) { return (connections = true); };
+
+    // wait returns once the timer is due and runs it
+    bool fired = false;
+    Timer timer(Timer::begin::now);
+    timers.schedule(30, [&] () { fired = true; });
+    EXPECT_TRUE(connectionWait.wait(notifyCallback, connectionCallback, timers));
+    EXPECT_TRUE(fired);
+    EXPECT_GE(timer.runningMillis(), 29);
+    EXPECT_FALSE(notify);
+    EXPECT_FALSE(connections);
+
+    // timer scheduled by another thread while waiting on an empty wheel wakes up the wait without a notify
+    fired = false;
+    timer.start();
+    std::thread scheduler([&timers, &fired] () {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        timers.schedule(20, [&fired] () { fired = true; });
+    });
+    while (!fired && timer.runningMillis() < 5000)
+        EXPECT_TRUE(connectionWait.wait(notifyCallback, connectionCallback, timers));
+    scheduler.join();
+
+    EXPECT_TRUE(fired);
+    EXPECT_LT(timer.runningMillis(), 5000);
+    EXPECT_FALSE(notify);
+
+    // notifies still reach the callback
+    connectionWait.notify();
+    EXPECT_TRUE(connectionWait.wait(notifyCallback, connectionCallback, timers));
+    EXPECT_TRUE(notify);
+    EXPECT_FALSE(connections);
+
+    // due timers run even if the notify callback fails
+    fired = false;
+    timers.schedule(1, [&] () { fired = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    connectionWait.notify();
+    EXPECT_FALSE(connectionWait.wait([] () { return false; }, connectionCallback, timers));
+    EXPECT_TRUE(fired);
+
+    // a wheel is driven by one wait at a time
+    bool otherThrew = false;
+    std::thread waiter([&] () {
+        try {
+            EXPECT_TRUE(connectionWait.wait(notifyCallback, connectionCallback, timers));
+        } catch (const connection_wait_error &) {
+            otherThrew = true;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    ConnectionWait otherWait;
+    EXPECT_THROW(otherWait.wait(notifyCallback, connectionCallback, timers), connection_wait_error);
+    connectionWait.notify();
+    waiter.join();
+    EXPECT_FALSE(otherThrew);
+}
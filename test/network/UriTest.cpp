@@ -20,6 +20,7 @@
 #include "UriTest.h"
 
 #include <network/component/Uri.h>
+#include <network/component/UriView.h>
 
 #define CHECK_URI(uri) \
     EXPECT_EQ((uri), Uri((uri)).str())
@@ -70,3 +71,80 @@ TEST_F(UriTest, testUriParse) {
     CHECK_URI("https://google.com/");
     CHECK_URI("vd://l/c:p:1/m:p:1");
 }
+
+TEST_F(UriTest, testEncode) {
+    EXPECT_EQ("", Uri::encode(""));
+    EXPECT_EQ("azAZ09-_.~", Uri::encode("azAZ09-_.~"));
+    EXPECT_EQ("languages%20and%20whatnot", Uri::encode("languages and whatnot"));
+    EXPECT_EQ("%25%2F%3F%26%3D%00%C3%BC", Uri::encode(std::string("%/?&=\0\xc3\xbc", 8)));
+
+    std::string input = "key=a long value with spaces & symbols";
+    std::string buffer(Uri::encodedSize(input), '\0');
+    EXPECT_EQ(buffer.size(), Uri::encode(input, buffer.data()));
+    EXPECT_EQ(Uri::encode(input), buffer);
+}
+
+TEST_F(UriTest, testDecode) {
+    EXPECT_EQ("", Uri::decode(""));
+    EXPECT_EQ("languages and whatnot", Uri::decode("languages%20and%20whatnot"));
+    EXPECT_EQ(std::string("%/?&=\0\xc3\xbc", 8), Uri::decode("%25%2f%3F%26%3D%00%C3%bc"));
+
+    // invalid escapes are kept
+    EXPECT_EQ("%", Uri::decode("%"));
+    EXPECT_EQ("a%2", Uri::decode("a%2"));
+    EXPECT_EQ("%zz%4g", Uri::decode("%zz%4g"));
+    EXPECT_EQ("%A", Uri::decode("%%41"));
+    EXPECT_EQ(3u, Uri::decodedSize("%%41%"));
+
+    std::string input = "%7Ba%7D%";
+    std::string buffer(Uri::decodedSize(input), '\0');
+    EXPECT_EQ(buffer.size(), Uri::decode(input, buffer.data()));
+    EXPECT_EQ("{a}%", buffer);
+
+    // round trip of all bytes
+    std::string all;
+    for (int c = 0; c < 256; c++)
+        all += static_cast<char>(c);
+    EXPECT_EQ(all, Uri::decode(Uri::encode(all)));
+}
+
+TEST_F(UriTest, testUriView) {
+    std::string str = "https://google.com//search/x?q=test&o%71=a%20b&q=other&=empty#languages%20and%20whatnot";
+    UriView uri(str);
+
+    EXPECT_EQ("https", uri.schema());
+    EXPECT_EQ("google.com", uri.host());
+    EXPECT_EQ("/search/x", uri.path());
+    std::vector<std::string> pp = { "search", "x" };
+    EXPECT_EQ(pp, std::vector<std::string>(uri.pathParts().begin(), uri.pathParts().end()));
+
+    // views into the original string
+    EXPECT_EQ(str.data(), uri.schema().data());
+    EXPECT_EQ("q=test&o%71=a%20b&q=other&=empty", uri.query());
+
+    // first match wins, keys are compared decoded
+    EXPECT_EQ("test", uri.queryValue("q"));
+    EXPECT_EQ("a b", uri.queryValue("oq"));
+    EXPECT_FALSE(uri.queryValue("o%71"));
+    EXPECT_FALSE(uri.queryValue(""));
+    EXPECT_EQ("fallback", uri.queryValue("abc", "fallback"));
+
+    EXPECT_EQ("languages%20and%20whatnot", uri.fragment());
+    EXPECT_EQ("", uri.fragmentValue("languages and whatnot"));
+
+    // same components and values as Uri
+    for (const char *input : {"vd://net/?h=abc.com&p=1234&s=false", "https://google.com/", "vd://l/c:p:1/m:p:1",
+                              "no-schema", "a://b", "a://b/c?d#e=f", "a://b/?k=1=2&k&x=%zz#%4B=v"}) {
+        Uri owned(input);
+        UriView view(input);
+
+        EXPECT_EQ(owned.schema(), view.schema()) << input;
+        EXPECT_EQ(owned.host(), view.host()) << input;
+        EXPECT_EQ(owned.path(), Str::joinAll(view.pathParts().begin(), view.pathParts().end(), "/")) << input;
+
+        for (const auto &pair : owned.queryParts())
+            EXPECT_EQ(owned.queryValue(pair.first), view.queryValue(pair.first)) << input;
+        for (const auto &pair : owned.fragmentParts())
+            EXPECT_EQ(owned.fragmentValue(pair.first), view.fragmentValue(pair.first)) << input;
+    }
+}
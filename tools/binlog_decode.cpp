@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/BinaryLog.h>
+
+#include <fstream>
+#include <iostream>
+
+/**
+ * Usage: commons_binlog_decode <binary log> [<text output>]
+ * Writes the text of all records to the output file or stdout.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <binary log> [<text output>]" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(argv[1], std::ios_base::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (argc == 3) {
+        file.open(argv[2]);
+        if (!file) {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!BinaryLogDecoder::decode(in, argc == 3 ? file : std::cout)) {
+        std::cerr << "Binary log is truncated or corrupt, decoded all complete records before" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2025 The ViaDuck Project
+ *
+ * This file is part of Commons.
+ *
+ * Commons is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Commons is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Commons.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <commons/log/impl/FlightRecorderLogger.h>
+
+#include <iostream>
+#include <string>
+
+/**
+ * Usage: commons_flightrec_dump <flight recorder file> [<max records>]
+ * Writes the most recent records in order to stdout.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <flight recorder file> [<max records>]" << std::endl;
+        return 2;
+    }
+
+    size_t maxRecords = argc == 3 ? std::stoul(argv[2]) : 0;
+    if (!FlightRecorderReader::read(argv[1], std::cout, maxRecords)) {
+        std::cerr << "Cannot read flight recorder file " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}